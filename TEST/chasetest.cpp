@@ -0,0 +1,117 @@
+/*
+Chase Test - for ElephantEye
+Copyright (C) 2026 ElephantEye contributors
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* ͳ׽ĲԳÿӸʼ桢ŷкظ㣺
+ *
+ * 1. "RepStatus()"صظλ(վֵӵһĽǶ)Ԥһ£
+ * 2. "MakeMove()"Ƴ"׽"ļ⣬"RepStatus()""ChkChs"ִŷʱĽһ¡
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../base/base.h"
+#include "../eleeye/position.h"
+
+const int MAX_CHASE_MOVES = 32;
+
+struct ChaseTestStruct {
+  const char *szName, *szFen, *szMoves;
+  int nRecur, nResult;
+};
+
+static const ChaseTestStruct ChaseTestList[] = {
+  // 쳵ÿֵӵĺ췽и
+  {"Perpetual check", "3k5/R8/9/9/9/9/9/9/9/4K4 w", "a8a9 d9d8 a9a8 d8d9", 1, REP_LOSS},
+  // ظβи
+  {"Check, 1 of 3", "3k5/R8/9/9/9/9/9/9/9/4K4 w", "a8a9 d9d8 a9a8 d8d9", 3, REP_NONE},
+  {"Check, 3 of 3", "3k5/R8/9/9/9/9/9/9/9/4K4 w",
+      "a8a9 d9d8 a9a8 d8d9 a8a9 d9d8 a9a8 d8d9 a8a9 d9d8 a9a8 d8d9", 3, REP_LOSS},
+  // 쳵׽޸ĺڣڷܣ췽иֵӵĺڷʤ
+  {"Perpetual chase", "3k5/9/9/9/R7c/9/9/9/9/4K4 b", "i5i6 a5a6 i6i5 a6a5", 1, REP_WIN},
+  // кڳ쳵׽к
+  {"Protected", "3k4r/9/9/9/R7c/9/9/9/9/4K4 b", "i5i6 a5a6 i6i5 a6a5", 1, REP_DRAW},
+  // ׽׽к
+  {"Rook on rook", "3k5/9/9/9/R7r/9/9/9/9/4K4 b", "i5i6 a5a6 i6i5 a6a5", 1, REP_DRAW},
+  // ׽ڳи(ڳ׽ĺк쳵׽)
+  {"Knight on rook", "3k5/9/9/9/9/r7R/9/1N7/9/4K4 b", "a4a5 b2c4 a5a4 c4b2", 1, REP_WIN},
+  // ˫ţк
+  {"Idle", "3k4r/9/9/9/9/9/9/9/9/R3K4 w", "a0a1 i9i8 a1a0 i8i9", 1, REP_DRAW},
+  // ûгظ
+  {"No repetition", "3k5/9/9/9/R7c/9/9/9/9/4K4 b", "i5i6 a5a6 i6i5", 1, REP_NONE},
+  {NULL, NULL, NULL, 0, 0}
+};
+
+static const char *const cszRepStatus[6] = {"None", "Draw", "", "Loss", "", "Win"};
+
+int main(void) {
+  const ChaseTestStruct *lpTest;
+  const char *lpMoveChar;
+  PositionStruct pos;
+  int i, nMoveNum, nResult, nChase[MAX_CHASE_MOVES], nFailed;
+  uint32_t dwMoveStr;
+
+  PreGenInit();
+  printf("Test                Expect Result\n");
+  printf("=================================\n");
+  fflush(stdout);
+  nFailed = 0;
+  for (lpTest = ChaseTestList; lpTest->szName != NULL; lpTest ++) {
+    pos.FromFen(lpTest->szFen);
+    pos.SetIrrev();
+    // 1. һִŷͬʱִŷʱĽ
+    nMoveNum = 0;
+    lpMoveChar = lpTest->szMoves;
+    while (*lpMoveChar != '\0' && nMoveNum < MAX_CHASE_MOVES) {
+      memcpy(&dwMoveStr, lpMoveChar, 4);
+      if (!pos.MakeMove(COORD_MOVE(dwMoveStr))) {
+        break;
+      }
+      nChase[nMoveNum] = (pos.LastMove().ChkChs == CHASE_LAZY ? -pos.ChasedBy(pos.LastMove().wmv) :
+          pos.LastMove().ChkChs);
+      nMoveNum ++;
+      lpMoveChar += (lpMoveChar[4] == ' ' ? 5 : 4);
+    }
+    if (*lpMoveChar != '\0') {
+      printf("%-20s Illegal Move: %.4s\n", lpTest->szName, lpMoveChar);
+      nFailed ++;
+      continue;
+    }
+    // 2. ظ棬ȽƳټĽ
+    nResult = pos.RepStatus(lpTest->nRecur);
+    printf("%-20s%-7s%s", lpTest->szName, cszRepStatus[lpTest->nResult], cszRepStatus[nResult]);
+    if (nResult != lpTest->nResult) {
+      printf(" Mismatch!");
+      nFailed ++;
+    }
+    if (nResult != REP_NONE) {
+      for (i = 0; i < nMoveNum; i ++) {
+        if (pos.rbsList[i + 1].mvs.ChkChs != CHASE_LAZY && pos.rbsList[i + 1].mvs.ChkChs != nChase[i]) {
+          printf(" Chase Mismatch at Move %d!", i + 1);
+          nFailed ++;
+          break;
+        }
+      }
+    }
+    printf("\n");
+    fflush(stdout);
+  }
+  printf("=================================\n");
+  printf("Failed: %d\n", nFailed);
+  return nFailed == 0 ? 0 : 1;
+}
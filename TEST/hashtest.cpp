@@ -0,0 +1,121 @@
+/*
+Hash File Test - for ElephantEye
+Copyright (C) 2026 ElephantEye contributors
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* ûļĲԳûм¼һ²ÿһûûб仯
+ * ÿ涼ܴûҵ¼ŷ
+ *
+ * 1. 浽ļٴļ(ûǴļӳ)
+ * 2. 浽ӳͬһļȻдû
+ * 3. ·ûٴļ롣
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../base/base.h"
+#include "../eleeye/position.h"
+#include "../eleeye/hash.h"
+
+const int TEST_POSITIONS = 200;
+const char *const cszHashFile = "hashtest.tt";
+
+// ûݵУ(FNV-1a)
+static uint64_t HashSum(void) {
+  const uint8_t *lpuc;
+  uint64_t qwSum;
+  int64_t i, llSize;
+  lpuc = (const uint8_t *) hshBuckets;
+  llSize = (llHashMask + 1) * sizeof(HashBucketStruct);
+  qwSum = 0xcbf29ce484222325;
+  for (i = 0; i < llSize; i ++) {
+    qwSum = (qwSum ^ lpuc[i]) * 0x100000001b3;
+  }
+  return qwSum;
+}
+
+// ӳʼ水̶Ĺ壬"bRecord"Ϊ"true"ʱ¼ÿ棬ÿ¼ŷ
+static int WalkPositions(bool bRecord) {
+  PositionStruct pos;
+  MoveStruct mvs[MAX_GEN_MOVES];
+  int i, nGenNum, mv, mvHash, nFailed;
+
+  pos.FromFen("rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w");
+  pos.nDistance = 0;
+  nFailed = 0;
+  for (i = 0; i < TEST_POSITIONS; i ++) {
+    nGenNum = pos.GenLegalMoves(mvs);
+    if (nGenNum == 0) {
+      break;
+    }
+    mv = mvs[(i * 7) % nGenNum].wmv;
+    if (bRecord) {
+      RecordHash(pos, HASH_BETA, i % 200 - 100, 1 + i % 10, mv);
+    } else {
+      ProbeHash(pos, -MATE_VALUE, MATE_VALUE, 1, false, mvHash);
+      if (mvHash != mv) {
+        nFailed ++;
+      }
+    }
+    pos.MakeMove(mv);
+  }
+  return nFailed;
+}
+
+// ûݺͼ¼ŷһн
+static int CheckStep(const char *szStep, bool bSuccess, uint64_t qwSum) {
+  int nFailed;
+  nFailed = (bSuccess ? 0 : 1) + (HashSum() == qwSum ? 0 : 1) + WalkPositions(false);
+  printf("%-32s%s\n", szStep, nFailed == 0 ? "Ok" : "Failed!");
+  fflush(stdout);
+  return nFailed;
+}
+
+int main(void) {
+  uint64_t qwSum;
+  int nFailed;
+  bool bSuccess;
+
+  PreGenInit();
+  NewHash(20);
+  WaitHash();
+  WalkPositions(true);
+  qwSum = HashSum();
+  nFailed = 0;
+
+  // 1. 浽ļٴļ룻
+  bSuccess = SaveHashFile(cszHashFile) && LoadHashFile(cszHashFile);
+  nFailed += CheckStep("Save and load", bSuccess, qwSum);
+
+  // 2. 浽ӳͬһļȻдû
+  bSuccess = SaveHashFile(cszHashFile);
+  nFailed += CheckStep("Save to the loaded file", bSuccess, qwSum);
+  WalkPositions(true);
+  nFailed += CheckStep("Record after saving", true, qwSum);
+
+  // 3. ·ûٴļ롣
+  DelHash();
+  NewHash(20);
+  WaitHash();
+  bSuccess = LoadHashFile(cszHashFile);
+  nFailed += CheckStep("Reload the saved file", bSuccess, qwSum);
+
+  DelHash();
+  remove(cszHashFile);
+  printf("%d Failed\n", nFailed);
+  return nFailed == 0 ? 0 : 1;
+}
@@ -1,3 +1,7 @@
 g++ -DNDEBUG -O4 -Wall -oUNITTEST.EXE ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp unittest.cpp
 g++ -DNDEBUG -O4 -Wall -oMAKETEST.EXE ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp ../cchess/cchess.cpp ../cchess/pgnfile.cpp maketest.cpp
-g++ -DNDEBUG -O4 -Wall -oUCCITEST.EXE ../base/pipe.cpp ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp uccitest.cpp
\ No newline at end of file
+g++ -DNDEBUG -O4 -Wall -oUCCITEST.EXE ../base/pipe.cpp ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp uccitest.cpp
+g++ -DNDEBUG -O4 -Wall -oSORTTEST.EXE ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp ../eleeye/movesort.cpp sorttest.cpp
+g++ -DNDEBUG -O4 -Wall -oCHASETEST.EXE ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp chasetest.cpp
+g++ -DNDEBUG -O4 -Wall -oHASHTEST.EXE ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp ../eleeye/hash.cpp hashtest.cpp
+g++ -DNDEBUG -O4 -Wall -oPOSTEST.EXE ../base/pipe.cpp ../eleeye/ucci.cpp ../eleeye/pregen.cpp ../eleeye/position.cpp ../eleeye/genmoves.cpp ../eleeye/hash.cpp ../eleeye/book.cpp ../eleeye/movesort.cpp ../eleeye/preeval.cpp ../eleeye/evaluate.cpp ../eleeye/search.cpp postest.cpp
\ No newline at end of file
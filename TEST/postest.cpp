@@ -0,0 +1,144 @@
+/*
+Position Command Test - for ElephantEye
+Copyright (C) 2026 ElephantEye contributors
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* "position"ָĲԳȰ̶Ĺ߳һ壬ģ淢һ"position ... moves ..."ָ
+ * ͨÿһŷҲظ͡ͻFEN
+ * ÿָһ"UpdatePos()"ع沢Ԥۣͬʱ"BuildPos()"ͷһ沢Ԥۣ
+ * Zobristֵֵͻعбһ(عбеֵ⣬"ComparePos()")
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../base/base.h"
+#include "../eleeye/position.h"
+#include "../eleeye/ucci.h"
+#include "../eleeye/search.h"
+
+const int GAME_MOVES = 200;
+
+static const char *const cszFenList[2] = {
+  "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w",
+  "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w"
+};
+
+// ÿָһӵŷʾ
+static const int cnStepList[8] = {1, 2, 1, 0, 1, -2, 3, 1};
+
+// FENʼ̶Ĺ壬ŷȣߵŷ
+static int MakeGame(const char *szFen, uint32_t *lpdwCoord) {
+  PositionStruct pos;
+  MoveStruct mvs[MAX_GEN_MOVES];
+  int i, j, nGenNum, mv;
+  uint32_t dwRand;
+
+  pos.FromFen(szFen);
+  dwRand = 1;
+  for (i = 0; i < GAME_MOVES; i ++) {
+    nGenNum = pos.GenLegalMoves(mvs);
+    if (nGenNum == 0) {
+      break;
+    }
+    dwRand = dwRand * 1103515245 + 12345;
+    mv = mvs[(dwRand >> 16) % nGenNum].wmv;
+    if ((dwRand >> 8) % 4 == 0) {
+      for (j = 0; j < nGenNum; j ++) {
+        if (pos.ucpcSquares[DST(mvs[j].wmv)] != 0) {
+          mv = mvs[j].wmv;
+          break;
+        }
+      }
+    }
+    lpdwCoord[i] = MOVE_COORD(mv);
+    pos.MakeMove(mv);
+    if (pos.LastMove().CptDrw > 0) {
+      pos.SetIrrev();
+    }
+  }
+  return i;
+}
+
+/* Ƚ棬زһµ
+ *
+ * عбеִֵǸŷʱԤµֵʱǰŷǰԤִеģ
+ * ԺʹͷĲֻͬڳǰʱŻõ("position.cpp"е"SetChase()")
+ * ˻عбֻȽZobristֵŷ(׽ͳӵı)ֵֻȽԤԺǰġ
+ */
+static int ComparePos(const PositionStruct &posInc, const PositionStruct &posFull) {
+  int i, nFailed;
+  nFailed = 0;
+  if (posInc.sdPlayer != posFull.sdPlayer || memcmp(posInc.ucpcSquares, posFull.ucpcSquares, 256) != 0) {
+    nFailed ++;
+  }
+  if (memcmp(&posInc.zobr, &posFull.zobr, sizeof(ZobristStruct)) != 0) {
+    nFailed ++;
+  }
+  if (posInc.vlWhite != posFull.vlWhite || posInc.vlBlack != posFull.vlBlack) {
+    nFailed ++;
+  }
+  if (posInc.nMoveNum != posFull.nMoveNum) {
+    return nFailed + 1;
+  }
+  for (i = 0; i < posInc.nMoveNum; i ++) {
+    if (memcmp(&posInc.rbsList[i].zobr, &posFull.rbsList[i].zobr, sizeof(ZobristStruct)) != 0 ||
+        posInc.rbsList[i].mvs.dwmv != posFull.rbsList[i].mvs.dwmv) {
+      nFailed ++;
+    }
+  }
+  return nFailed;
+}
+
+int main(void) {
+  static PositionStruct posInc, posFull;
+  uint32_t dwCoordList[GAME_MOVES];
+  UcciCommStruct UcciComm;
+  int i, nGameMoves, nMoveNum, nCommands, nFailed, nFenFailed;
+
+  PreGenInit();
+  printf("FEN  Moves Commands Result\n");
+  printf("==========================\n");
+  fflush(stdout);
+  nFailed = 0;
+  for (i = 0; i < 2; i ++) {
+    nGameMoves = MakeGame(cszFenList[i], dwCoordList);
+    UcciComm.szFenStr = cszFenList[i];
+    UcciComm.lpdwMovesCoord = dwCoordList;
+    nMoveNum = nCommands = nFenFailed = 0;
+    while (nMoveNum < nGameMoves) {
+      nMoveNum = MIN(MAX(nMoveNum + cnStepList[nCommands % 8], 0), nGameMoves);
+      UcciComm.nMoveNum = nMoveNum;
+      // 洦"position"ָһԤۣ涼ҪͬһԤ¹
+      UpdatePos(posInc, UcciComm);
+      BuildPos(posFull, UcciComm);
+      posInc.nDistance = 0;
+      posInc.PreEvaluate();
+      posFull.nDistance = 0;
+      posFull.PreEvaluate();
+      if (ComparePos(posInc, posFull) > 0) {
+        printf("Mismatch at %d moves\n", nMoveNum);
+        nFenFailed ++;
+      }
+      nCommands ++;
+    }
+    printf("%-5d%-6d%-9d%s\n", i + 1, nGameMoves, nCommands, nFenFailed == 0 ? "Ok" : "Failed!");
+    fflush(stdout);
+    nFailed += nFenFailed;
+  }
+  printf("%d Failed\n", nFailed);
+  return nFailed == 0 ? 0 : 1;
+}
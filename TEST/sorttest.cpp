@@ -0,0 +1,170 @@
+/*
+Sort Test - for ElephantEye
+Copyright (C) 2026 ElephantEye contributors
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* ŷĲԳ򣬱ȽShell("ShellSort()")ѡ("PickBest()")ַ
+ *
+ * 1. ̬ŷMVV(LVA)ֵ
+ * 2. ȫŷʷʷ䣻
+ * ÿֱֻȡ1ŷ(ضϽĵ)ȡǰ3ŷȡȫŷĺʱ
+ * ַȡŷֵһ£򱨸
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../base/base.h"
+#include "../base/parse.h"
+#include "../eleeye/position.h"
+#include "../eleeye/movesort.h"
+
+const int MAX_CHAR = 1024;
+const int MAX_POS = 1024;
+const int CONSUME_NUM = 3;
+const int CONSUME_ALL = MAX_GEN_MOVES;
+
+static const int cnConsume[CONSUME_NUM] = {1, 3, CONSUME_ALL};
+static const char *const cszConsume[CONSUME_NUM] = {"First 1", "First 3", "All"};
+
+// Ծǰŷб
+struct SortListStruct {
+  int nMoveNum;
+  MoveStruct mvs[MAX_GEN_MOVES];
+};
+
+static SortListStruct QuiescList[MAX_POS], FullList[MAX_POS];
+
+// Shellȡǰ"nConsume"ŷǷֵĺ
+static int ShellConsume(MoveSortStruct &MoveSort, const SortListStruct &List, int nConsume) {
+  int i, nSum;
+  MoveSort.nMoveIndex = 0;
+  MoveSort.nMoveNum = List.nMoveNum;
+  memcpy(MoveSort.mvs, List.mvs, List.nMoveNum * sizeof(MoveStruct));
+  MoveSort.ShellSort();
+  nSum = 0;
+  for (i = 0; i < nConsume && i < MoveSort.nMoveNum; i ++) {
+    nSum += MoveSort.mvs[i].wvl;
+  }
+  return nSum;
+}
+
+// ѡȡǰ"nConsume"ŷǷֵĺ
+static int PickConsume(MoveSortStruct &MoveSort, const SortListStruct &List, int nConsume) {
+  int nSum;
+  MoveSort.nMoveIndex = 0;
+  MoveSort.nMoveNum = List.nMoveNum;
+  memcpy(MoveSort.mvs, List.mvs, List.nMoveNum * sizeof(MoveStruct));
+  nSum = 0;
+  while (MoveSort.nMoveIndex < nConsume && MoveSort.nMoveIndex < MoveSort.nMoveNum) {
+    MoveSort.PickBest();
+    nSum += MoveSort.mvs[MoveSort.nMoveIndex].wvl;
+    MoveSort.nMoveIndex ++;
+  }
+  return nSum;
+}
+
+// һŷбֱַԣʱ()
+static void TestLists(const char *szName, const SortListStruct *lpList, int nPosNum, int nRepeat) {
+  int i, j, k, nShellSum, nPickSum;
+  int64_t llTime, llShellTime, llPickTime;
+  MoveSortStruct MoveSort;
+  for (i = 0; i < CONSUME_NUM; i ++) {
+    nShellSum = nPickSum = 0;
+    llTime = GetTime();
+    for (j = 0; j < nRepeat; j ++) {
+      for (k = 0; k < nPosNum; k ++) {
+        nShellSum += ShellConsume(MoveSort, lpList[k], cnConsume[i]);
+      }
+    }
+    llShellTime = GetTime() - llTime;
+    llTime = GetTime();
+    for (j = 0; j < nRepeat; j ++) {
+      for (k = 0; k < nPosNum; k ++) {
+        nPickSum += PickConsume(MoveSort, lpList[k], cnConsume[i]);
+      }
+    }
+    llPickTime = GetTime() - llTime;
+    printf("%-8s %-8s %8d %8d%s\n", szName, cszConsume[i], (int) llShellTime, (int) llPickTime,
+        nShellSum == nPickSum ? "" : " Mismatch!");
+    fflush(stdout);
+  }
+}
+
+int main(int argc, char **argv) {
+  char szLineStr[MAX_CHAR];
+  char *lpLineChar;
+  PositionStruct pos;
+  MoveSortStruct MoveSort;
+  FILE *fp;
+  int i, nPosNum, nRepeat, nQuiescMoves, nFullMoves;
+  uint32_t dwRand;
+
+  if (argc <= 1) {
+    printf("=== ElephantEye Sort Test Program ===\n");
+    printf("Usage: SORTTEST EPD-File [Repeat-Times]\n");
+    return 0;
+  }
+  fp = fopen(argv[1], "rt");
+  if (fp == NULL) {
+    printf("%s: File Opening Error!\n", argv[1]);
+    return 0;
+  }
+  nRepeat = (argc > 2 ? Str2Digit(argv[2], 1, 1000000) : 1000);
+  PreGenInit();
+
+  // 1. ʷģеʷ
+  dwRand = 1;
+  for (i = 0; i < 65536; i ++) {
+    dwRand = dwRand * 1103515245 + 12345;
+    nHistory[i] = (int) ((dwRand >> 16) % (HISTORY_MAX * 2 + 1)) - HISTORY_MAX;
+  }
+
+  // 2. 棬ɳŷȫŷ
+  nPosNum = nQuiescMoves = nFullMoves = 0;
+  while (nPosNum < MAX_POS && fgets(szLineStr, MAX_CHAR, fp) != NULL) {
+    lpLineChar = szLineStr;
+    if (StrEqvSkip(lpLineChar, "position fen ")) {
+      // ֧"BATCH.TXT"UCCIָļ
+    } else if (strchr(lpLineChar, '/') == NULL) {
+      continue;
+    }
+    pos.FromFen(lpLineChar);
+    MoveSort.InitQuiesc(pos);
+    QuiescList[nPosNum].nMoveNum = MoveSort.nMoveNum;
+    memcpy(QuiescList[nPosNum].mvs, MoveSort.mvs, MoveSort.nMoveNum * sizeof(MoveStruct));
+    MoveSort.InitAll(pos);
+    FullList[nPosNum].nMoveNum = MoveSort.nMoveNum;
+    memcpy(FullList[nPosNum].mvs, MoveSort.mvs, MoveSort.nMoveNum * sizeof(MoveStruct));
+    nQuiescMoves += QuiescList[nPosNum].nMoveNum;
+    nFullMoves += FullList[nPosNum].nMoveNum;
+    nPosNum ++;
+  }
+  fclose(fp);
+  if (nPosNum == 0) {
+    printf("%s: No Position!\n", argv[1]);
+    return 0;
+  }
+  printf("Positions: %d, Captures: %d, Moves: %d, Repeat: %d\n", nPosNum, nQuiescMoves, nFullMoves, nRepeat);
+
+  // 3. ֱԾ̬ȫŷб
+  printf("Search   Consume     Shell     Pick\n");
+  printf("=====================================\n");
+  fflush(stdout);
+  TestLists("Quiesc", QuiescList, nPosNum, nRepeat);
+  TestLists("Full", FullList, nPosNum, nRepeat);
+  return 0;
+}
@@ -4,6 +4,9 @@
   #include <pthread.h>
   #include <stdlib.h>
   #include <unistd.h>
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
 #endif
 #include <string.h>
 #include "base.h"
@@ -29,9 +32,67 @@ inline void GetSelfExe(char *szDst) {
   GetModuleFileName(NULL, szDst, PATH_MAX_CHAR);
 }
 
-inline void StartThread(void *ThreadEntry(void *), void *lpParameter) {
+// ̣߳ʧʱ"false"
+inline bool StartThread(void *ThreadEntry(void *), void *lpParameter) {
   DWORD dwThreadId;
-  CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) ThreadEntry, (LPVOID) lpParameter, 0, &dwThreadId);
+  HANDLE hThread;
+  hThread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) ThreadEntry, (LPVOID) lpParameter, 0, &dwThreadId);
+  if (hThread == NULL) {
+    return false;
+  }
+  CloseHandle(hThread);
+  return true;
+}
+
+inline int GetCpuCount(void) {
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  return (int) si.dwNumberOfProcessors;
+}
+
+// ڴ棬ʹôҳ(Ҫ"ڴҳ"Ȩ)ʧʱNULL
+inline void *LargeAlloc(int64_t llSize) {
+  void *lp;
+  SIZE_T nLargePage;
+  nLargePage = GetLargePageMinimum();
+  if (nLargePage > 0 && llSize % nLargePage == 0) {
+    lp = VirtualAlloc(NULL, (SIZE_T) llSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (lp != NULL) {
+      return lp;
+    }
+  }
+  return VirtualAlloc(NULL, (SIZE_T) llSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+inline void LargeFree(void *lp, int64_t llSize) {
+  VirtualFree(lp, 0, MEM_RELEASE);
+}
+
+// ļһӳ䵽ڴ(дʱƣдݲӰļ)ļʧʱNULL
+inline void *MapFile(const char *szFileName, int64_t llOffset, int64_t llSize) {
+  HANDLE hFile, hMap;
+  LARGE_INTEGER liFileSize;
+  void *lp;
+  hFile = CreateFile(szFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (hFile == INVALID_HANDLE_VALUE) {
+    return NULL;
+  }
+  if (!GetFileSizeEx(hFile, &liFileSize) || liFileSize.QuadPart < llOffset + llSize) {
+    CloseHandle(hFile);
+    return NULL;
+  }
+  hMap = CreateFileMapping(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(hFile);
+  if (hMap == NULL) {
+    return NULL;
+  }
+  lp = MapViewOfFile(hMap, FILE_MAP_COPY, (DWORD) (llOffset >> 32), (DWORD) llOffset, (SIZE_T) llSize);
+  CloseHandle(hMap);
+  return lp;
+}
+
+inline void UnmapFile(void *lp, int64_t llSize) {
+  UnmapViewOfFile(lp);
 }
 
 #else
@@ -50,12 +111,72 @@ inline void GetSelfExe(char *szDst) {
   readlink("/proc/self/exe", szDst, PATH_MAX_CHAR);
 }
 
-inline void StartThread(void *ThreadEntry(void *), void *lpParameter) {
+// ̣߳ʧʱ"false"
+inline bool StartThread(void *ThreadEntry(void *), void *lpParameter) {
   pthread_t pthread;
   pthread_attr_t pthread_attr;
+  int nResult;
   pthread_attr_init(&pthread_attr);
   pthread_attr_setscope(&pthread_attr, PTHREAD_SCOPE_SYSTEM);
-  pthread_create(&pthread, &pthread_attr, ThreadEntry, lpParameter);
+  pthread_attr_setdetachstate(&pthread_attr, PTHREAD_CREATE_DETACHED);
+  nResult = pthread_create(&pthread, &pthread_attr, ThreadEntry, lpParameter);
+  pthread_attr_destroy(&pthread_attr);
+  return nResult == 0;
+}
+
+inline int GetCpuCount(void) {
+  return (int) sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+const int64_t LARGE_PAGE_SIZE = 1 << 21; // ҳĴС(2MB)
+
+/* ڴ棬ʹԤĴҳ棬͸ҳ棬ʧʱNULL
+ * ҳӳᱻȡҳ"LargeFree()"ǰԭĴСӳģֻҳСʱʹôҳ
+ */
+inline void *LargeAlloc(int64_t llSize) {
+  void *lp;
+#ifdef MAP_HUGETLB
+  if (llSize % LARGE_PAGE_SIZE == 0) {
+    lp = mmap(NULL, (size_t) llSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (lp != MAP_FAILED) {
+      return lp;
+    }
+  }
+#endif
+  lp = mmap(NULL, (size_t) llSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (lp == MAP_FAILED) {
+    return NULL;
+  }
+#ifdef MADV_HUGEPAGE
+  madvise(lp, (size_t) llSize, MADV_HUGEPAGE);
+#endif
+  return lp;
+}
+
+inline void LargeFree(void *lp, int64_t llSize) {
+  munmap(lp, (size_t) llSize);
+}
+
+// ļһӳ䵽ڴ(дʱƣдݲӰļ)ļʧʱNULL
+inline void *MapFile(const char *szFileName, int64_t llOffset, int64_t llSize) {
+  int fd;
+  struct stat st;
+  void *lp;
+  fd = open(szFileName, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) < 0 || st.st_size < llOffset + llSize) {
+    close(fd);
+    return NULL;
+  }
+  lp = mmap(NULL, (size_t) llSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) llOffset);
+  close(fd);
+  return lp == MAP_FAILED ? NULL : lp;
+}
+
+inline void UnmapFile(void *lp, int64_t llSize) {
+  munmap(lp, (size_t) llSize);
 }
 
 #endif
@@ -113,7 +113,7 @@ void PipeStruct::Close(void) const {
 
 void PipeStruct::ReadInput(void) {
   DWORD dwBytes;
-  if (ReadFile(hInput, szBuffer + nReadEnd, LINE_INPUT_MAX_CHAR - nReadEnd, &dwBytes, NULL)) {
+  if (ReadFile(hInput, szBuffer + nReadEnd, LINE_INPUT_MAX_CHAR - nReadEnd, &dwBytes, NULL) && dwBytes > 0) {
     nReadEnd += dwBytes;
     if (nBytesLeft > 0) {
       nBytesLeft -= dwBytes;
@@ -123,18 +123,30 @@ void PipeStruct::ReadInput(void) {
   }
 }
 
-bool PipeStruct::CheckInput(void) {
-  DWORD dwEvents, dwBytes;
-  if (bConsole) { // a tty, or an un-redirected handle
-    GetNumberOfConsoleInputEvents(hInput, &dwEvents);
-    return dwEvents > 1;
-  } else if (nBytesLeft > 0) { // a pipe with remainder data
-    return true;
-  } else if (PeekNamedPipe(hInput, NULL, 0, NULL, &dwBytes, NULL)) { // a pipe without remainder data 
-    nBytesLeft = dwBytes;
-    return nBytesLeft > 0;
-  } else { // a file, always true
-    return true;
+bool PipeStruct::CheckInput(int nTimeout) {
+  DWORD dwEvents, dwBytes, dwStart;
+  dwStart = GetTickCount();
+  while (true) {
+    if (bConsole) { // a tty, or an un-redirected handle
+      GetNumberOfConsoleInputEvents(hInput, &dwEvents);
+      if (dwEvents > 1) {
+        return true;
+      }
+    } else if (nBytesLeft > 0) { // a pipe with remainder data
+      return true;
+    } else if (PeekNamedPipe(hInput, NULL, 0, NULL, &dwBytes, NULL)) { // a pipe without remainder data 
+      nBytesLeft = dwBytes;
+      if (nBytesLeft > 0) {
+        return true;
+      }
+    } else { // a file, always true
+      return true;
+    }
+    // anonymous pipes cannot be waited on, so poll until the timeout expires
+    if ((int) (GetTickCount() - dwStart) >= nTimeout) {
+      return false;
+    }
+    Sleep(1);
   }
 }
 
@@ -200,21 +212,21 @@ void PipeStruct::Close(void) const {
 void PipeStruct::ReadInput(void) {
   int n;
   n = read(nInput, szBuffer + nReadEnd, LINE_INPUT_MAX_CHAR - nReadEnd);
-  if (n < 0) {
-    nEof = 1;
-  } else {
+  if (n > 0) {
     nReadEnd += n;
+  } else {
+    nEof = 1;
   }
 }
 
-bool PipeStruct::CheckInput(void) {
+bool PipeStruct::CheckInput(int nTimeout) {
   fd_set set;
   timeval tv;
   int val;
   FD_ZERO(&set);
   FD_SET(nInput, &set);
-  tv.tv_sec = 0;
-  tv.tv_usec = 0;
+  tv.tv_sec = nTimeout / 1000;
+  tv.tv_usec = nTimeout % 1000 * 1000;
   val = select(nInput + 1, &set, NULL, NULL, &tv);
   return (val > 0 && FD_ISSET(nInput, &set) > 0);
 }
@@ -251,10 +263,10 @@ bool PipeStruct::GetBuffer(char *szLineStr) {
   }
 }
 
-bool PipeStruct::LineInput(char *szLineStr) {
+bool PipeStruct::LineInput(char *szLineStr, int nTimeout) {
   if (GetBuffer(szLineStr)) {
     return true;
-  } else if (CheckInput()) {
+  } else if (nEof == 0 && CheckInput(nTimeout)) {
     ReadInput();
     if (GetBuffer(szLineStr)) {
       return true;
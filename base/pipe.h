@@ -23,9 +23,9 @@ struct PipeStruct {
   void Open(const char *szExecFile = NULL);
   void Close(void) const;
   void ReadInput(void);
-  bool CheckInput(void);
+  bool CheckInput(int nTimeout = 0);
   bool GetBuffer(char *szLineStr);
-  bool LineInput(char *szLineStr);
+  bool LineInput(char *szLineStr, int nTimeout = 0);
   void LineOutput(const char *szLineStr) const;
 }; // pipe
 
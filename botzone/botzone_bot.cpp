@@ -35,7 +35,7 @@ int main() {
     Search.pos.nDistance = 0;
     Search.pos.PreEvaluate();
     Search.nBanMoves = 0;
-    Search.bQuit = Search.bBatch = Search.bDebug = false;
+    Search.bQuit = Search.bBatch = Search.bDebug = Search.bStats = Search.bQuiet = false;
     Search.bUseHash = Search.bNullMove = Search.bKnowledge = true;
     Search.bUseBook = false;
     Search.bIdle = false;
@@ -81,7 +81,7 @@ int GetBookMoves(const PositionStruct &pos, const char *szBookFile, BookStruct *
     if (BOOK_POS_CMP(bk, posScan) > 0) {
       break;
     }
-    if (posScan.LegalMove(bk.wmv)) {
+    if (posScan.LegalMove(bk.wmv) && posScan.MoveSafe(bk.wmv)) {
       // ǵڶģŷ
       lpbks[nMoves].nPtr = nPtr;
       lpbks[nMoves].wmv = (nScan == 0 ? bk.wmv : MOVE_MIRROR(bk.wmv));
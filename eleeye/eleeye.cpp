@@ -26,8 +26,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ucci.h"
 #include "pregen.h"
 #include "position.h"
+#include "preeval.h"
 #include "hash.h"
+#include "movesort.h"
 #include "search.h"
+#include "perft.h"
 
 const int INTERRUPT_COUNT = 4096; // ɽж
 
@@ -36,29 +39,161 @@ inline void PrintLn(const char *sz) {
   fflush(stdout);
 }
 
-int main(void) {
+/* ׼õһ(֡оֺͲо)̶ȵܽÿ
+ *
+ * ûȶȡĬϴСѡҲȡĬֵ(ÿֿ⡢߳)ÿǰûʷ
+ * ˽ֻͳйأĬ¿ΪǩĶǷӰΪ
+ * ԽָԭľѡûȵĴСҲָѱա
+ */
+const int BENCH_POS_NUM = 8;
+const int BENCH_DEPTH = 9;
+const int BENCH_SIGNATURE = 3424301;
+
+static const char *const cszBenchFen[BENCH_POS_NUM] = {
+  "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w",
+  "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w",
+  "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w",
+  "5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w",
+  "CRN1k1b2/3ca4/4ba3/9/2nr5/9/9/4B4/4A4/4KA3 w",
+  "3k2r2/2P1a4/9/9/4N4/7r1/9/4B3C/9/4RK3 w",
+  "4ka3/4a4/8b/9/4N4/9/9/1R5C1/2pCp4/3K1nnc1 w",
+  "4kab2/4a4/8b/9/9/9/9/9/9/4K1R2 w"
+};
+
+// ĴС2Ķٴη
+static int SizeScale(int64_t llSize) {
+  int nScale;
+  nScale = 0;
+  while (llSize > 1) {
+    llSize /= 2;
+    nScale ++;
+  }
+  return nScale;
+}
+
+// ׼ԣΪ0ʱȡĬȣؽǩǷ(ĬȲȽ)
+static bool Bench(int nDepth) {
+  static SearchStruct SearchSave;
+  int i, nNodes, nTime, nAllNodes, nAllTime, nHashScale, nHashScaleQ, nEvalCacheScale;
+  int64_t llTime;
+  bool bPromotion, bSigned;
+
+  // 1. ԭľ桢ѡԼûȵĴСȻĬֵ
+  SearchSave = Search;
+  bPromotion = PreEval.bPromotion;
+  nHashScale = SizeScale((llHashMask + 1) * sizeof(HashBucketStruct));
+  nHashScaleQ = (lpqwHashQ == NULL ? 0 : SizeScale((llHashMaskQ + 1) * sizeof(uint64_t)));
+  nEvalCacheScale = (lpqwEvalCache == NULL ? 0 : SizeScale(((int64_t) dwEvalCacheMask + 1) * sizeof(uint64_t)));
+  DelEvalCache();
+  DelHashQ();
+  DelHash();
+  NewHash(24);
+  NewEvalCache(16);
+  PreEval.bPromotion = false;
+  Search.bPonder = Search.bDraw = Search.bDebug = Search.bStats = Search.bIdle = false;
+  Search.bBatch = true; // ׼ʱָ
+  Search.bQuiet = true; // ׼ʱҪŷ
+  Search.bUseHash = Search.bNullMove = Search.bKnowledge = true;
+  Search.bUseBook = false;
+  Search.nGoMode = GO_MODE_INFINITY;
+  Search.nNodes = 0;
+  Search.nCountMask = INTERRUPT_COUNT - 1;
+  Search.nRandomMask = 0;
+  Search.nBanMoves = 0;
+  Search.nThreads = 1;
+  Search.nPruning = 3;
+  nDepth = (nDepth == 0 ? BENCH_DEPTH : nDepth);
+
+  // 2. һÿ棻
+  nAllNodes = nAllTime = 0;
+  for (i = 0; i < BENCH_POS_NUM; i ++) {
+    Search.pos.FromFen(cszBenchFen[i]);
+    Search.pos.nDistance = 0;
+    Search.pos.PreEvaluate();
+    ClearHash();
+    ClearHistory();
+    llTime = GetTime();
+    SearchMain(nDepth);
+    nTime = (int) (GetTime() - llTime);
+    nNodes = Search.nAllNodes;
+    printf("info bench position %d depth %d nodes %d time %d\n", i + 1, nDepth, nNodes, nTime);
+    fflush(stdout);
+    nAllNodes += nNodes;
+    nAllTime += nTime;
+  }
+
+  // 3. ܽÿĬºǩȽϣ
+  bSigned = (nDepth != BENCH_DEPTH || nAllNodes == BENCH_SIGNATURE);
+  printf("info bench nodes %d time %d nps %d signature %s\n", nAllNodes, nAllTime,
+      (int) ((int64_t) nAllNodes * 1000 / MAX(nAllTime, 1)),
+      nDepth != BENCH_DEPTH ? "none" : bSigned ? "ok" : "drift");
+  fflush(stdout);
+
+  // 4. ָԭľ桢ѡԼûȵĴС
+  DelEvalCache();
+  DelHash();
+  NewHash(nHashScale);
+  if (nHashScaleQ > 0) {
+    NewHashQ(nHashScaleQ);
+  }
+  if (nEvalCacheScale > 0) {
+    NewEvalCache(nEvalCacheScale);
+  }
+  ClearHistory();
+  PreEval.bPromotion = bPromotion;
+  Search = SearchSave;
+  // Ԥ۵ݻһ׼ԾģҪԭľ¼
+  Search.pos.PreEvaluate();
+  return bSigned;
+}
+
+int main(int argc, char **argv) {
   int i;
-  bool bPonderTime;
+  int64_t llNodes, llTime;
+  bool bPonderTime, bBench, bPerft;
+  char szHashFile[1024];
   UcciCommStruct UcciComm;
   PositionStruct posProbe;
 
-  if (BootLine() != UCCI_COMM_UCCI) {
+  /* "ELEEYE bench [<depth>]"ֻ׼ԣǩʱطֵ
+   * "ELEEYE perft [<depth> [<threads>]]"ֻ֪ľֲʱطֵ
+   * "ucci"ָ
+   */
+  bBench = (argc > 1 && StrEqv(argv[1], "bench"));
+  bPerft = (argc > 1 && StrEqv(argv[1], "perft"));
+  if (!bBench && !bPerft && BootLine() != UCCI_COMM_UCCI) {
     return 0;
   }
   LocatePath(Search.szBookFile, "BOOK.DAT");
   bPonderTime = false;
   PreGenInit();
   NewHash(24); // 24=16MB, 25=32MB, 26=64MB, ...
+  NewEvalCache(16); // 16=64KB
   Search.pos.FromFen(cszStartFen);
   Search.pos.nDistance = 0;
   Search.pos.PreEvaluate();
   Search.nBanMoves = 0;
-  Search.bQuit = Search.bBatch = Search.bDebug = false;
+  Search.bQuit = Search.bBatch = Search.bDebug = Search.bStats = Search.bQuiet = false;
   Search.bUseHash = Search.bUseBook = Search.bNullMove = Search.bKnowledge = true;
   Search.bIdle = false;
   Search.nCountMask = INTERRUPT_COUNT - 1;
   Search.nRandomMask = 0;
+  Search.nThreads = 1;
+  Search.nPruning = 3;
   Search.rc4Random.InitRand();
+  if (bBench) {
+    i = (Bench(argc > 2 ? Str2Digit(argv[2], 1, UCCI_MAX_DEPTH) : 0) ? 0 : 1);
+    DelEvalCache();
+    DelHash();
+    return i;
+  }
+  if (bPerft) {
+    i = (PerftSuite(argc > 2 ? Str2Digit(argv[2], 1, UCCI_MAX_DEPTH) : PERFT_SUITE_DEPTH,
+        argc > 3 ? Str2Digit(argv[3], 1, PERFT_MAX_THREADS) : 1) ? 0 : 1);
+    DelEvalCache();
+    DelHash();
+    return i;
+  }
   PrintLn("id name ElephantEye");
   PrintLn("id version 3.31");
   PrintLn("id copyright 2004-2016 www.xqbase.com");
@@ -68,12 +203,17 @@ int main(void) {
   PrintLn("option promotion type check default false");
   PrintLn("option batch type check default false");
   PrintLn("option debug type check default false");
+  PrintLn("option stats type check default false");
   PrintLn("option ponder type check default false");
   PrintLn("option usehash type check default true");
   PrintLn("option usebook type check default true");
   printf("option bookfiles type string default %s\n", Search.szBookFile);
   fflush(stdout);
-  PrintLn("option hashsize type spin min 16 max 1024 default 16");
+  printf("option hashsize type spin min 16 max %d default 16\n", UCCI_MAX_HASHSIZE);
+  printf("option qhashsize type spin min 0 max %d default 0\n", UCCI_MAX_HASHSIZE);
+  printf("option evalcache type spin min 0 max %d default 64\n", UCCI_MAX_EVALCACHE);
+  printf("option threads type spin min 1 max %d default 1\n", MAX_THREADS);
+  fflush(stdout);
   PrintLn("option idle type combo var none var small var medium var large default none");
   PrintLn("option pruning type combo var none var small var medium var large default large");
   PrintLn("option knowledge type combo var none var small var medium var large default large");
@@ -85,13 +225,15 @@ int main(void) {
   while (!Search.bQuit) {
     switch (IdleLine(UcciComm, Search.bDebug)) {
     case UCCI_COMM_ISREADY:
+      // ûں̨գϲ׼
+      WaitHash();
       PrintLn("readyok");
       break;
     case UCCI_COMM_STOP:
       PrintLn("nobestmove");
       break;
     case UCCI_COMM_POSITION:
-      BuildPos(Search.pos, UcciComm);
+      UpdatePos(Search.pos, UcciComm);
       Search.pos.nDistance = 0;
       Search.pos.PreEvaluate();
       Search.nBanMoves = 0;
@@ -113,6 +255,9 @@ int main(void) {
       case UCCI_OPTION_DEBUG:
         Search.bDebug = UcciComm.bCheck;
         break;
+      case UCCI_OPTION_STATS:
+        Search.bStats = UcciComm.bCheck;
+        break;
       case UCCI_OPTION_PONDER:
         bPonderTime = UcciComm.bCheck;
         break;
@@ -138,6 +283,31 @@ int main(void) {
         }
         NewHash(MAX(i, 24)); // СûΪ16M
         break;
+      case UCCI_OPTION_QHASHSIZE:
+        DelHashQ();
+        if (UcciComm.nSpin > 0) {
+          i = 19;
+          while (UcciComm.nSpin > 0) {
+            UcciComm.nSpin /= 2;
+            i ++;
+          }
+          NewHashQ(i);
+        }
+        break;
+      case UCCI_OPTION_EVALCACHE:
+        DelEvalCache();
+        if (UcciComm.nSpin > 0) {
+          i = 9; // ۻĴСKBΪλ
+          while (UcciComm.nSpin > 0) {
+            UcciComm.nSpin /= 2;
+            i ++;
+          }
+          NewEvalCache(i);
+        }
+        break;
+      case UCCI_OPTION_THREADS:
+        Search.nThreads = MIN(MAX(UcciComm.nSpin, 1), MAX_THREADS);
+        break;
       case UCCI_OPTION_IDLE:
         switch (UcciComm.Grade) {
         case UCCI_GRADE_NONE:
@@ -161,7 +331,21 @@ int main(void) {
         }
         break;
       case UCCI_OPTION_PRUNING:
-        Search.bNullMove = (UcciComm.Grade != UCCI_GRADE_NONE);
+        switch (UcciComm.Grade) {
+        case UCCI_GRADE_NONE:
+          Search.nPruning = 0;
+          break;
+        case UCCI_GRADE_SMALL:
+          Search.nPruning = 1;
+          break;
+        case UCCI_GRADE_MEDIUM:
+          Search.nPruning = 2;
+          break;
+        default:
+          Search.nPruning = 3;
+          break;
+        }
+        Search.bNullMove = (Search.nPruning > 0);
         break;
       case UCCI_OPTION_KNOWLEDGE:
         Search.bKnowledge = (UcciComm.Grade != UCCI_GRADE_NONE);
@@ -190,6 +374,11 @@ int main(void) {
           break;
         }
         break;
+      case UCCI_OPTION_NEWGAME:
+        // µĶԾ֣ûʷƽʱ֮ǱЩϢ
+        ClearHash();
+        ClearHistory();
+        break;
       default:
         break;
       }
@@ -236,6 +425,31 @@ int main(void) {
         PopLeaf(posProbe);
       }
       break;
+    case UCCI_COMM_SAVEHASH:
+      LocatePath(szHashFile, UcciComm.szFileName); // ·ڵĿ¼
+      printf(SaveHashFile(szHashFile) ? "info hashfile saved %s\n" : "info hashfile error %s\n", szHashFile);
+      fflush(stdout);
+      break;
+    case UCCI_COMM_LOADHASH:
+      LocatePath(szHashFile, UcciComm.szFileName); // ·ڵĿ¼
+      printf(LoadHashFile(szHashFile) ? "info hashfile loaded %s\n" : "info hashfile error %s\n", szHashFile);
+      fflush(stdout);
+      break;
+    case UCCI_COMM_BENCH:
+      Bench(UcciComm.nBenchDepth);
+      break;
+    case UCCI_COMM_PERFT:
+      if (UcciComm.bPerftHash) {
+        NewPerftHash(PERFT_HASH_SCALE);
+      }
+      llTime = GetTime();
+      llNodes = PerftRoot(Search.pos, UcciComm.nPerftDepth, Search.nThreads, UcciComm.bDivide);
+      i = (int) (GetTime() - llTime);
+      printf("info perft depth %d nodes %lld time %d nps %lld\n", UcciComm.nPerftDepth, (long long) llNodes, i,
+          (long long) (llNodes * 1000 / MAX(i, 1)));
+      fflush(stdout);
+      DelPerftHash();
+      break;
     case UCCI_COMM_QUIT:
       Search.bQuit = true;
       break;
@@ -243,6 +457,8 @@ int main(void) {
       break;
     }
   }
+  DelEvalCache();
+  DelHashQ();
   DelHash();
   PrintLn("bye");
   return 0;
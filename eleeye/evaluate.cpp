@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "../base/base.h"
+#include "../base/base2.h"
 #include "pregen.h"
 #include "position.h"
 #include "preeval.h"
@@ -39,11 +40,60 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  * smv: λкλеŷжԤýṹ("pregen.h")
  */
 
-// ͵۵ı߽
-const int EVAL_MARGIN1 = 160;
-const int EVAL_MARGIN2 = 80;
-const int EVAL_MARGIN3 = 40;
-const int EVAL_MARGIN4 = 20;
+// ۻ
+uint32_t dwEvalCacheMask;
+uint64_t *lpqwEvalCache = NULL;
+uint32_t dwEvalCacheSalt = 0;
+thread_local int nEvalCacheProbes = 0;
+thread_local int nEvalCacheHits = 0;
+thread_local int nEvalStageExits[EVAL_STAGE_NUM];
+
+// ۻ棬С 2^nCacheScale ֽڣڴ治ʱʹ
+void NewEvalCache(int nCacheScale) {
+  dwEvalCacheMask = (uint32_t) ((((int64_t) 1 << nCacheScale) / sizeof(uint64_t)) - 1);
+  lpqwEvalCache = (uint64_t *) LargeAlloc((int64_t) (dwEvalCacheMask + 1) * sizeof(uint64_t));
+}
+
+// ͷۻ
+void DelEvalCache(void) {
+  if (lpqwEvalCache != NULL) {
+    LargeFree(lpqwEvalCache, (int64_t) (dwEvalCacheMask + 1) * sizeof(uint64_t));
+    lpqwEvalCache = NULL;
+  }
+}
+
+// ۻеУ16λ͵16λֱĸ16λ
+inline uint64_t EvalCacheLock(const PositionStruct &pos) {
+  uint32_t dwLock;
+  dwLock = pos.zobr.dwLock0 ^ dwEvalCacheSalt;
+  return ((uint64_t) (dwLock >> 16) << 48) | ((uint64_t) (dwLock & 0xffff) << 16);
+}
+
+const uint64_t EVAL_CACHE_LOCK_MASK = 0xffff0000ffff0000;
+
+// ̽ۻ棬͵۵ĲΣʱֵŵ"vl"Уûʱ0
+inline int ProbeEvalCache(const PositionStruct &pos, int &vl) {
+  uint64_t qw;
+  if (lpqwEvalCache == NULL) {
+    return 0;
+  }
+  nEvalCacheProbes ++;
+  qw = lpqwEvalCache[pos.zobr.dwKey & dwEvalCacheMask];
+  if ((qw & EVAL_CACHE_LOCK_MASK) != EvalCacheLock(pos)) {
+    return 0;
+  }
+  nEvalCacheHits ++;
+  vl = (int16_t) (uint16_t) (qw >> 32);
+  return (int) (qw & 7);
+}
+
+// ¼ۻ棬"nStage""vl"۲
+inline void RecordEvalCache(const PositionStruct &pos, int vl, int nStage) {
+  if (lpqwEvalCache != NULL) {
+    lpqwEvalCache[pos.zobr.dwKey & dwEvalCacheMask] = EvalCacheLock(pos) |
+        ((uint64_t) (uint16_t) vl << 32) | (uint64_t) nStage;
+  }
+}
 
 // ģֻ漰"PositionStruct"е"sdPlayer""ucpcSquares""ucsqPieces""wBitPiece"ĸԱʡǰ"this->"
 
@@ -572,41 +622,72 @@ int PositionStruct::KnightTrap(void) const {
 
 // ۹
 int PositionStruct::Evaluate(int vlAlpha, int vlBeta) const {
-  int vl;
+  int vl, vlLazy, nStage, nCacheStage;
   // ͵ľۺ¼Σ
 
   // 1. ļ͵(͵)ֻƽ⣻
   vl = this->Material();
   if (vl + EVAL_MARGIN1 <= vlAlpha) {
+    nEvalStageExits[0] ++;
     return vl + EVAL_MARGIN1;
   } else if (vl - EVAL_MARGIN1 >= vlBeta) {
+    nEvalStageExits[0] ++;
     return vl - EVAL_MARGIN1;
   }
 
-  // 2. ͵ۣͣ
-  vl += this->AdvisorShape();
-  if (vl + EVAL_MARGIN2 <= vlAlpha) {
-    return vl + EVAL_MARGIN2;
-  } else if (vl - EVAL_MARGIN2 >= vlBeta) {
-    return vl - EVAL_MARGIN2;
-  }
-
-  // 3. ͵ۣǣƣ
-  vl += this->StringHold();
-  if (vl + EVAL_MARGIN3 <= vlAlpha) {
-    return vl + EVAL_MARGIN3;
-  } else if (vl - EVAL_MARGIN3 >= vlBeta) {
-    return vl - EVAL_MARGIN3;
+  // ¼ε۶ȽϷʱۻ¼ϴ۵ĲΣʱǸμ
+  nStage = nCacheStage = ProbeEvalCache(*this, vl);
+  switch (nStage) {
+  case 0:
+    vl += this->AdvisorShape();
+    nStage = 1;
+    // fall through
+  case 1:
+    // 2. ͵ۣͣ
+    if (vl + EVAL_MARGIN2 <= vlAlpha) {
+      vlLazy = vl + EVAL_MARGIN2;
+      break;
+    } else if (vl - EVAL_MARGIN2 >= vlBeta) {
+      vlLazy = vl - EVAL_MARGIN2;
+      break;
+    }
+    vl += this->StringHold();
+    nStage = 2;
+    // fall through
+  case 2:
+    // 3. ͵ۣǣƣ
+    if (vl + EVAL_MARGIN3 <= vlAlpha) {
+      vlLazy = vl + EVAL_MARGIN3;
+      break;
+    } else if (vl - EVAL_MARGIN3 >= vlBeta) {
+      vlLazy = vl - EVAL_MARGIN3;
+      break;
+    }
+    vl += this->RookMobility();
+    nStage = 3;
+    // fall through
+  case 3:
+    // 4. һ͵ۣԣ
+    if (vl + EVAL_MARGIN4 <= vlAlpha) {
+      vlLazy = vl + EVAL_MARGIN4;
+      break;
+    } else if (vl - EVAL_MARGIN4 >= vlBeta) {
+      vlLazy = vl - EVAL_MARGIN4;
+      break;
+    }
+    vl += this->KnightTrap();
+    nStage = 4;
+    // fall through
+  default:
+    // 5. 㼶͵(ȫ)谭
+    vlLazy = vl;
+    break;
   }
 
-  // 4. һ͵ۣԣ
-  vl += this->RookMobility();
-  if (vl + EVAL_MARGIN4 <= vlAlpha) {
-    return vl + EVAL_MARGIN4;
-  } else if (vl - EVAL_MARGIN4 >= vlBeta) {
-    return vl - EVAL_MARGIN4;
+  // ۵ĲαȻе͸ۻ
+  nEvalStageExits[nStage] ++;
+  if (nStage > nCacheStage) {
+    RecordEvalCache(*this, vl, nStage);
   }
-
-  // 5. 㼶͵(ȫ)谭
-  return vl + this->KnightTrap();
+  return vlLazy;
 }
@@ -40,145 +40,258 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 // ģֻ漰"PositionStruct"е"sdPlayer""ucpcSquares""ucsqPieces"Աʡǰ"this->"
 
-// ӱж
+/* ӱж
+ *
+ * "CheckedBy()"һܳԵøӵıӲһλУ()ֻȺûʱܱ
+ * ˧()(ʿ)()ԤֻǳڻͬһߵĸӣǲܱԷߵӣ˲жϰߡ
+ */
 bool PositionStruct::Protected(int sd, int sqSrc, int sqExcept) const {
   // "sqExcept"ʾų(ָӱ)ǱǣӵıʱҪųǣĿӵı
-  int i, sqDst, sqPin, pc, x, y, nSideTag;
+  int i, x, y, nBitBoard;
   SlideMaskStruct *lpsmsRank, *lpsmsFile;
+  BitBoardStruct bbProtectors, bbKnights, bbBishops;
   // ӱжϰ¼裺
 
   __ASSERT_SQUARE(sqSrc);
-  nSideTag = SIDE_TAG(sd);
-  if (HOME_HALF(sqSrc, sd)) {
-    if (IN_FORT(sqSrc)) {
+  nBitBoard = sd * 7;
 
-      // 1. жܵ˧()ı
-      sqDst = ucsqPieces[nSideTag + KING_FROM];
-      if (sqDst != 0 && sqDst != sqExcept) {
-        __ASSERT_SQUARE(sqDst);
-        if (KING_SPAN(sqSrc, sqDst)) {
-          return true;
-        }
-      }
+  // 1. жܵ()ıӱ()Ժ򱣻
+  bbProtectors = PreGen.bbPawnAttackTab[sd][sqSrc] & bbPieces[nBitBoard + PAWN_TYPE];
 
-      // 2. жܵ(ʿ)ı
-      for (i = ADVISOR_FROM; i <= ADVISOR_TO; i ++) {
-        sqDst = ucsqPieces[nSideTag + i];
-        if (sqDst != 0 && sqDst != sqExcept) {
-          __ASSERT_SQUARE(sqDst);
-          if (ADVISOR_SPAN(sqSrc, sqDst)) {
-            return true;
-          }
-        }
+  // 2. жܵڵı
+  x = FILE_X(sqSrc);
+  y = RANK_Y(sqSrc);
+  lpsmsRank = RankMaskPtr(x, y);
+  lpsmsFile = FileMaskPtr(x, y);
+  bbProtectors = bbProtectors | (SlideBitBoard(x, y, lpsmsRank->wRookCap, lpsmsFile->wRookCap) & bbPieces[nBitBoard + ROOK_TYPE]);
+  bbProtectors = bbProtectors | (SlideBitBoard(x, y, lpsmsRank->wCannonCap, lpsmsFile->wCannonCap) & bbPieces[nBitBoard + CANNON_TYPE]);
+
+  // 3. жܵ˧()(ʿ)ı
+  bbProtectors = bbProtectors | (PreGen.bbKingAttackTab[sqSrc] & bbPieces[nBitBoard + KING_TYPE]);
+  bbProtectors = bbProtectors | (PreGen.bbAdvisorAttackTab[sqSrc] & bbPieces[nBitBoard + ADVISOR_TYPE]);
+
+  // 4. жܵ()ıȺ۶Ǹøӵбڸ
+  bbKnights = bbPieces[nBitBoard + KNIGHT_TYPE];
+  bbBishops = bbPieces[nBitBoard + BISHOP_TYPE];
+  if (!(bbKnights | bbBishops).IsZero()) {
+    for (i = 0; i < 4; i ++) {
+      if (ucpcSquares[sqSrc + cnDiagonalTab[i]] == 0) {
+        bbProtectors = bbProtectors | (PreGen.bbKnightAttackTab[sqSrc][i] & bbKnights);
+        bbProtectors = bbProtectors | (PreGen.bbBishopAttackTab[sqSrc][i] & bbBishops);
       }
     }
+  }
 
-    // 3. жܵ()ı
-    for (i = BISHOP_FROM; i <= BISHOP_TO; i ++) {
-      sqDst = ucsqPieces[nSideTag + i];
-      if (sqDst != 0 && sqDst != sqExcept) {
-        __ASSERT_SQUARE(sqDst);
-        if (BISHOP_SPAN(sqSrc, sqDst) && ucpcSquares[BISHOP_PIN(sqSrc, sqDst)] == 0) {
-          return true;
-        }
+  // 5. ų"sqExcept"ı
+  if (sqExcept != 0) {
+    bbProtectors.qwLow &= ~PreGen.bbSquareMask[sqExcept].qwLow;
+    bbProtectors.qwHigh &= ~PreGen.bbSquareMask[sqExcept].qwHigh;
+  }
+  return !bbProtectors.IsZero();
+}
+
+/* ̬(SEE)
+ *
+ * ̬ģ˫ĿüֵСӳӣõŷľ÷֣йصϸ£
+ * 1. ڵĹĿλкλе"wRookCap""wCannonCap"жϣ
+ *    뽻뿪ʹλкλȥĳ()ڼܵı仯Զǵ
+ * 2. ȺϵѾ뽻(뿪ԭĸ)ô()Ͳٱ
+ * 3. ˧()ֻûжԷܳԻʱŲ뽻ҲܳԵͶԷ˧()λϡ
+ * вǣƣҲǳӺɵĽ
+ */
+
+// ̬۵ֵ(˧ڱ)趨ӱ()ļֵӱ
+static const int cnSeeValues[7] = {1000, 20, 20, 40, 90, 45, 10};
+
+inline int SeeValue(int pc, int sq) {
+  int pt;
+  pt = PIECE_TYPE(pc);
+  return (pt == PAWN_TYPE && AWAY_HALF(sq, (pc & 32) == 0 ? 0 : 1)) ? cnSeeValues[pt] * 2 : cnSeeValues[pt];
+}
+
+// 뽻Ӽϣ(1647)¼
+inline uint64_t SEE_BIT(int pc) {
+  return (uint64_t) 1 << pc;
+}
+
+// ̬״̬¼ĿڵλСλкѾ뽻
+struct SeeStruct {
+  int sqDst, x, y;
+  uint16_t wRank, wFile;
+  uint64_t qwUsed;
+
+  void Remove(int pc, int sq) { // 뿪ԭĸӲ뽻
+    qwUsed |= SEE_BIT(pc);
+    if (RANK_Y(sq) == y) {
+      wRank &= ~PreGen.wBitRankMask[sq];
+    }
+    if (FILE_X(sq) == x) {
+      wFile &= ~PreGen.wBitFileMask[sq];
+    }
+  }
+};
+
+// ȻǷû
+inline bool SeePinFree(const PositionStruct &pos, const SeeStruct &see, int sqPin) {
+  int pc;
+  pc = pos.ucpcSquares[sqPin];
+  return pc == 0 || (see.qwUsed & SEE_BIT(pc)) != 0;
+}
+
+// ҵ"sd"һܳԵĿļֵСӣû򷵻0
+static int SeeAttacker(const PositionStruct &pos, const SeeStruct &see, int sd) {
+  int i, sq, pc, nSideTag;
+  SlideMaskStruct *lpsmsRank, *lpsmsFile;
+  nSideTag = SIDE_TAG(sd);
+
+  // 1. ()Ӻ󻹿Ժ
+  sq = SQUARE_BACKWARD(see.sqDst, sd);
+  pc = pos.ucpcSquares[sq];
+  if ((pc & nSideTag) != 0 && PIECE_INDEX(pc) >= PAWN_FROM && (see.qwUsed & SEE_BIT(pc)) == 0) {
+    return pc;
+  }
+  if (AWAY_HALF(see.sqDst, sd)) {
+    for (sq = see.sqDst - 1; sq <= see.sqDst + 1; sq += 2) {
+      pc = pos.ucpcSquares[sq];
+      if ((pc & nSideTag) != 0 && PIECE_INDEX(pc) >= PAWN_FROM && (see.qwUsed & SEE_BIT(pc)) == 0) {
+        return pc;
       }
     }
   } else {
 
-    // 4. жܵӱ()ı
-    for (sqDst = sqSrc - 1; sqDst <= sqSrc + 1; sqDst += 2) {
-      // ڱߣôԲ
-      // __ASSERT_SQUARE(sqDst);
-      if (sqDst != sqExcept) {
-        pc = ucpcSquares[sqDst];
-        if ((pc & nSideTag) != 0 && PIECE_INDEX(pc) >= PAWN_FROM) {
-          return true;
+    // 2. (ʿ)()ֻڱ߳
+    if (IN_FORT(see.sqDst)) {
+      for (i = ADVISOR_FROM; i <= ADVISOR_TO; i ++) {
+        sq = pos.ucsqPieces[nSideTag + i];
+        if (sq != 0 && (see.qwUsed & SEE_BIT(nSideTag + i)) == 0 && ADVISOR_SPAN(see.sqDst, sq)) {
+          return nSideTag + i;
         }
       }
     }
-  }
-
-  // 5. жܵ()ı
-  sqDst = SQUARE_BACKWARD(sqSrc, sd);
-  // ڵߣôԲ
-  // __ASSERT_SQUARE(sqDst);
-  if (sqDst != sqExcept) {
-    pc = ucpcSquares[sqDst];
-    if ((pc & nSideTag) != 0 && PIECE_INDEX(pc) >= PAWN_FROM) {
-      return true;
+    for (i = BISHOP_FROM; i <= BISHOP_TO; i ++) {
+      sq = pos.ucsqPieces[nSideTag + i];
+      if (sq != 0 && (see.qwUsed & SEE_BIT(nSideTag + i)) == 0 && BISHOP_SPAN(see.sqDst, sq) &&
+          SeePinFree(pos, see, BISHOP_PIN(see.sqDst, sq))) {
+        return nSideTag + i;
+      }
     }
   }
 
-  // 6. жܵı
+  // 3. 
   for (i = KNIGHT_FROM; i <= KNIGHT_TO; i ++) {
-    sqDst = ucsqPieces[nSideTag + i];
-    if (sqDst != 0 && sqDst != sqExcept) {
-      __ASSERT_SQUARE(sqDst);
-      sqPin = KNIGHT_PIN(sqDst, sqSrc); // ע⣬sqSrcsqDstǷģ
-      if (sqPin != sqDst && ucpcSquares[sqPin] == 0) {
-        return true;
+    sq = pos.ucsqPieces[nSideTag + i];
+    if (sq != 0 && (see.qwUsed & SEE_BIT(nSideTag + i)) == 0) {
+      pc = KNIGHT_PIN(sq, see.sqDst); // "pc"ʱȵĸ
+      if (pc != sq && SeePinFree(pos, see, pc)) {
+        return nSideTag + i;
       }
     }
   }
 
-  x = FILE_X(sqSrc);
-  y = RANK_Y(sqSrc);
-  lpsmsRank = RankMaskPtr(x, y);
-  lpsmsFile = FileMaskPtr(x, y);
-
-  // 7. жܵı"position.cpp""CheckedBy()"
-  for (i = ROOK_FROM; i <= ROOK_TO; i ++) {
-    sqDst = ucsqPieces[nSideTag + i];
-    if (sqDst != 0 && sqDst != sqSrc && sqDst != sqExcept) {
-      if (x == FILE_X(sqDst)) {
-        if ((lpsmsFile->wRookCap & PreGen.wBitFileMask[sqDst]) != 0) {
-          return true;
+  // 4. ںͳĿڵλкλж
+  lpsmsRank = PreGen.smsRankMaskTab[see.x - FILE_LEFT] + see.wRank;
+  lpsmsFile = PreGen.smsFileMaskTab[see.y - RANK_TOP] + see.wFile;
+  for (i = CANNON_FROM; i <= CANNON_TO; i ++) {
+    sq = pos.ucsqPieces[nSideTag + i];
+    if (sq != 0 && (see.qwUsed & SEE_BIT(nSideTag + i)) == 0) {
+      if (see.x == FILE_X(sq)) {
+        if ((lpsmsFile->wCannonCap & PreGen.wBitFileMask[sq]) != 0) {
+          return nSideTag + i;
         }
-      } else if (y == RANK_Y(sqDst)) {
-        if ((lpsmsRank->wRookCap & PreGen.wBitRankMask[sqDst]) != 0) {
-          return true;
+      } else if (see.y == RANK_Y(sq)) {
+        if ((lpsmsRank->wCannonCap & PreGen.wBitRankMask[sq]) != 0) {
+          return nSideTag + i;
         }
       }
     }
   }
-
-  // 8. жܵڵı"position.cpp""CheckedBy()"
-  for (i = CANNON_FROM; i <= CANNON_TO; i ++) {
-    sqDst = ucsqPieces[nSideTag + i];
-    if (sqDst && sqDst != sqSrc && sqDst != sqExcept) {
-      if (x == FILE_X(sqDst)) {
-        if ((lpsmsFile->wCannonCap & PreGen.wBitFileMask[sqDst]) != 0) {
-          return true;
+  for (i = ROOK_FROM; i <= ROOK_TO; i ++) {
+    sq = pos.ucsqPieces[nSideTag + i];
+    if (sq != 0 && (see.qwUsed & SEE_BIT(nSideTag + i)) == 0) {
+      if (see.x == FILE_X(sq)) {
+        if ((lpsmsFile->wRookCap & PreGen.wBitFileMask[sq]) != 0) {
+          return nSideTag + i;
         }
-      } else if (y == RANK_Y(sqDst)) {
-        if ((lpsmsRank->wCannonCap & PreGen.wBitRankMask[sqDst]) != 0) {
-          return true;
+      } else if (see.y == RANK_Y(sq)) {
+        if ((lpsmsRank->wRookCap & PreGen.wBitRankMask[sq]) != 0) {
+          return nSideTag + i;
         }
       }
     }
   }
-  return false;
+
+  // 5. ˧()ܳԵͶԷ˧()λ
+  sq = pos.ucsqPieces[nSideTag + KING_FROM];
+  if (sq != 0 && (see.qwUsed & SEE_BIT(nSideTag + KING_FROM)) == 0 && IN_FORT(see.sqDst) && KING_SPAN(see.sqDst, sq)) {
+    pc = pos.ucsqPieces[OPP_SIDE_TAG(sd) + KING_FROM]; // "pc"ʱԷ˧()ĸ
+    if (pc == 0 || FILE_X(pc) != see.x || (lpsmsFile->wRookCap & PreGen.wBitFileMask[pc]) == 0) {
+      return nSideTag + KING_FROM;
+    }
+  }
+  return 0;
+}
+
+// ŷľֵ̬ۣ"cnSeeValues"Ϊλ
+int PositionStruct::See(int mv) const {
+  int i, sd, pc, vlAttacker;
+  int vlGain[33];
+  SeeStruct see;
+
+  // 1. ʼ״̬ɵһγӣ
+  see.sqDst = DST(mv);
+  see.x = FILE_X(see.sqDst);
+  see.y = RANK_Y(see.sqDst);
+  see.wRank = wBitRanks[see.y];
+  see.wFile = wBitFiles[see.x];
+  see.qwUsed = 0;
+  pc = ucpcSquares[SRC(mv)];
+  vlGain[0] = SeeValue(ucpcSquares[see.sqDst], see.sqDst);
+  vlAttacker = SeeValue(pc, see.sqDst);
+  see.Remove(pc, SRC(mv));
+
+  // 2. ˫üֵСӳԻأ˧()ֻڶԷٳԻʱųԣ
+  sd = OPP_SIDE(sdPlayer);
+  i = 1;
+  while ((pc = SeeAttacker(*this, see, sd)) != 0) {
+    see.Remove(pc, ucsqPieces[pc]);
+    if (PIECE_INDEX(pc) == KING_FROM && SeeAttacker(*this, see, OPP_SIDE(sd)) != 0) {
+      break;
+    }
+    vlGain[i] = vlAttacker - vlGain[i - 1];
+    vlAttacker = SeeValue(pc, see.sqDst);
+    i ++;
+    sd = OPP_SIDE(sd);
+  }
+
+  // 3. ӽĩ˵ƣÿһѡٳԻء
+  while (-- i > 0) {
+    vlGain[i - 1] = -MAX(-vlGain[i - 1], vlGain[i]);
+  }
+  return vlGain[0];
 }
 
 /* MVV(LVA)ֵĺ
  *
- * MVV(LVA)ָǣޱôȡֵMVVȡֵMVV-LVA
- * ElephantEyeMVV(LVA)ֵڼϺټ1ǣ¼ֺ壺
- * a. MVV(LVA)1˵Ӽֵڹ(׬)ֳӽ̬Ҳֳӣ
- * b. MVV(LVA)1˵һֵ(ԳڻԹӱ䣬ǿģҲֵһ)̬Ҳֳӣ
- * c. MVV(LVA)0˵ûмֳֵ̬ӡ
+ * MVV(LVA)ָǣޱôȡֵMVVþ̬жϳӵĵʧ׬ȡֵMVV-LVA
+ * ElephantEyeMVV(LVA)ֵڼϺټ12¼ֺ壺
+ * a. MVV(LVA)1˵ޱ̬׬ģֳӽ̬Ҳֳӣ
+ * b. MVV(LVA)1˵̬ǵֵģ̬Ҳֳӣ
+ * c. MVV(LVA)0˵̬ǿģֳӷŵŷֳ̬ӡ
  *
  * MVVֵ"SIMPLE_VALUE"ǰ˧()=5=4=3()=2(ʿ)()=1趨ģ
  * LVAֱֵڳŷС
  */
-int PositionStruct::MvvLva(int sqDst, int pcCaptured, int nLva) const {
-  int nMvv, nLvaAdjust;
+int PositionStruct::MvvLva(int sqSrc, int sqDst, int pcCaptured, int nLva) const {
+  int nMvv, vlSee;
   nMvv = SIMPLE_VALUE(pcCaptured);
-  nLvaAdjust = (Protected(OPP_SIDE(sdPlayer), sqDst) ? nLva : 0);
-  if (nMvv >= nLvaAdjust) {
-    return nMvv - nLvaAdjust + 1;
+  if (!Protected(OPP_SIDE(sdPlayer), sqDst)) {
+    return nMvv + 1;
+  }
+  vlSee = See(MOVE(sqSrc, sqDst));
+  if (vlSee > 0) {
+    return MAX(nMvv - nLva, 0) + 2;
   } else {
-    return (nMvv >= 3 || HOME_HALF(sqDst, sdPlayer)) ? 1 : 0;
+    return vlSee == 0 ? 1 : 0;
   }
 }
 
@@ -211,7 +324,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
       if ((pcCaptured & nOppSideTag) != 0) {
         __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
         lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-        lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 5); // ˧()ļֵ5
+        lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 5); // ˧()ļֵ5
         lpmvsCurr ++;
       }
       lpucsqDst ++;
@@ -232,7 +345,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 1); // (ʿ)ļֵ1
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 1); // (ʿ)ļֵ1
           lpmvsCurr ++;
         }
         lpucsqDst ++;
@@ -261,7 +374,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
           if ((pcCaptured & nOppSideTag) != 0) {
             __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
             lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-            lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 1); // ()ļֵ1
+            lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 1); // ()ļֵ1
             lpmvsCurr ++;
           }
         }
@@ -292,7 +405,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
           if ((pcCaptured & nOppSideTag) != 0) {
             __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
             lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-            lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 3); // ļֵ3
+            lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 3); // ļֵ3
             lpmvsCurr ++;
           }
         }
@@ -319,7 +432,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 4); // ļֵ4
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 4); // ļֵ4
           lpmvsCurr ++;
         }
       }
@@ -330,7 +443,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 4); // ļֵ4
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 4); // ļֵ4
           lpmvsCurr ++;
         }
       }
@@ -343,7 +456,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 4); // ļֵ4
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 4); // ļֵ4
           lpmvsCurr ++;
         }
       }
@@ -354,7 +467,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 4); // ļֵ4
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 4); // ļֵ4
           lpmvsCurr ++;
         }
       }
@@ -377,7 +490,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 3); // ڵļֵ3
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 3); // ڵļֵ3
           lpmvsCurr ++;
         }
       }
@@ -388,7 +501,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 3); // ڵļֵ3
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 3); // ڵļֵ3
           lpmvsCurr ++;
         }
       }
@@ -401,7 +514,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 3); // ڵļֵ3
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 3); // ڵļֵ3
           lpmvsCurr ++;
         }
       }
@@ -412,7 +525,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 3); // ڵļֵ3
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 3); // ڵļֵ3
           lpmvsCurr ++;
         }
       }
@@ -432,7 +545,7 @@ int PositionStruct::GenCapMoves(MoveStruct *lpmvs) const {
         if ((pcCaptured & nOppSideTag) != 0) {
           __ASSERT(LegalMove(MOVE(sqSrc, sqDst)));
           lpmvsCurr->wmv = MOVE(sqSrc, sqDst);
-          lpmvsCurr->wvl = MvvLva(sqDst, pcCaptured, 2); // ()ļֵ2
+          lpmvsCurr->wvl = MvvLva(sqSrc, sqDst, pcCaptured, 2); // ()ļֵ2
           lpmvsCurr ++;
         }
         lpucsqDst ++;
@@ -609,6 +722,20 @@ int PositionStruct::GenNonCapMoves(MoveStruct *lpmvs) const {
   return lpmvsCurr - lpmvs;
 }
 
+// Ϸŷͽŷ"MoveSafe()"ȥִкͳŷ
+int PositionStruct::GenLegalMoves(MoveStruct *lpmvs) {
+  int i, nGenNum, nLegal;
+  nGenNum = GenAllMoves(lpmvs);
+  nLegal = 0;
+  for (i = 0; i < nGenNum; i ++) {
+    if (MoveSafe(lpmvs[i].wmv)) {
+      lpmvs[nLegal] = lpmvs[i];
+      nLegal ++;
+    }
+  }
+  return nLegal;
+}
+
 // ׽ļ
 int PositionStruct::ChasedBy(int mv) const {
   int i, nSideTag, pcMoved, pcCaptured;
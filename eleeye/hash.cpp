@@ -24,15 +24,254 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
   #include <stdio.h>
 #endif
 #include "../base/base.h"
+#include "../base/base2.h"
+#include "pregen.h"
 #include "position.h"
 #include "hash.h"
 
-int nHashMask;
-HashStruct *hshItems;
-#ifdef HASH_QUIESC
-  HashStruct *hshItemsQ;
+int64_t llHashMask;
+HashBucketStruct *hshBuckets;
+uint8_t ucHashGen;
+int64_t llHashMaskQ;
+uint64_t *lpqwHashQ = NULL;
+thread_local int nHashProbes = 0;
+thread_local int nHashHits = 0;
+
+static bool bHashMapped = false;             // ûǷǴļӳ(ͷʱҪӳ)
+
+const int HASH_MIN_SCALE = 20;               // ûСС(1MB)ôСڴҲ䲻ʱʹþ̬û
+static HashBucketStruct hshMinBuckets[(1 << HASH_MIN_SCALE) / sizeof(HashBucketStruct)];
+
+const int MAX_CLEAR_THREADS = 64;            // û߳
+const int64_t CLEAR_BLOCK_SIZE = 1 << 24;    // ÿ߳16MB
+const int64_t CLEAR_BLOCK_ALIGN = 1 << 21;   // ÿ߳յ㰴2MB(ҳ)
+
+// ûĹ߳Ϣ̬ûҲҪõ
+static struct {
+  char *lpStart;                             // Ҫյ
+  int64_t llSize;                            // Ҫյֽ
+  volatile bool bBusy;                       // Ƿ
+} ClearThreads[MAX_CLEAR_THREADS * 2];
+static int nClearThreads = 0;                // ߳
+
+static void *ClearProc(void *lpParameter) {
+  int nThread;
+  nThread = (int) (intptr_t) lpParameter;
+  memset(ClearThreads[nThread].lpStart, 0, ClearThreads[nThread].llSize);
+  ClearThreads[nThread].bBusy = false;
+  return NULL;
+}
+
+/* ̲߳һڴ棬ÿ߳һ
+ *
+ * ڴҳڵһηʱģҷڷ߳ڵNUMAϣ
+ * ɶ̷ֱ߳գʹûȵطֲڸNUMAϡ
+ */
+static void StartClear(void *lp, int64_t llSize) {
+  int i, nThreads;
+  int64_t llStep;
+  nThreads = (int) MIN((int64_t) MIN(GetCpuCount(), MAX_CLEAR_THREADS), llSize / CLEAR_BLOCK_SIZE);
+  nThreads = MAX(nThreads, 1);
+  llStep = (llSize / nThreads + CLEAR_BLOCK_ALIGN - 1) & ~(CLEAR_BLOCK_ALIGN - 1);
+  for (i = 0; i < nThreads; i ++) {
+    ClearThreads[nClearThreads].lpStart = (char *) lp + llStep * i;
+    ClearThreads[nClearThreads].llSize = MAX(MIN(llStep, llSize - llStep * i), (int64_t) 0);
+    ClearThreads[nClearThreads].bBusy = true;
+    // ޷߳ʱɵԼһΣ"WaitHash()"һֱȥ
+    if (!StartThread(ClearProc, (void *) (intptr_t) nClearThreads)) {
+      ClearProc((void *) (intptr_t) nClearThreads);
+    }
+    nClearThreads ++;
+  }
+}
+
+// ȴû
+void WaitHash(void) {
+  int i;
+  for (i = 0; i < nClearThreads; i ++) {
+    while (ClearThreads[i].bBusy) {
+      Idle();
+    }
+  }
+  nClearThreads = 0;
+}
+
+// ûչɺ̨߳ɣʹûǰ"WaitHash()"
+void ClearHash(void) {
+  WaitHash();
+  StartClear(hshBuckets, (llHashMask + 1) * sizeof(HashBucketStruct));
+  if (lpqwHashQ != NULL) {
+    StartClear(lpqwHashQ, (llHashMaskQ + 1) * sizeof(uint64_t));
+  }
+}
+
+// ûС 2^nHashScale ֽڣڴ治ʱμ룬СȻʱʹþ̬û
+void NewHash(int nHashScale) {
+  while (true) {
+    llHashMask = (((int64_t) 1 << nHashScale) / sizeof(HashBucketStruct)) - 1;
+    hshBuckets = (HashBucketStruct *) LargeAlloc((llHashMask + 1) * sizeof(HashBucketStruct));
+    if (hshBuckets != NULL) {
+      break;
+    }
+    if (nHashScale <= HASH_MIN_SCALE) {
+      llHashMask = (int64_t) (sizeof(hshMinBuckets) / sizeof(HashBucketStruct)) - 1;
+      hshBuckets = hshMinBuckets;
+      break;
+    }
+    nHashScale --;
+  }
+  bHashMapped = false;
+  ClearHash();
+}
+
+// ͷû
+void DelHash(void) {
+  WaitHash();
+  if (bHashMapped) {
+    UnmapFile(hshBuckets, (llHashMask + 1) * sizeof(HashBucketStruct));
+  } else if (hshBuckets != hshMinBuckets) {
+    LargeFree(hshBuckets, (llHashMask + 1) * sizeof(HashBucketStruct));
+  }
+}
+
+#ifndef CCHESS_A3800
+
+/* ûļĸʽ
+ *
+ * ļͷ֮0䵽"HASH_FILE_OFFSET"ֽڣȻûȫͰ
+ * ûƽ̨ӳļĶҪ(Windows64KB)ֱӳ䵽ڴ档
+ * ļͷ¼ûĸʽZobristֵУֻͣк͵ǰһµļʹá
+ */
+const uint32_t HASH_FILE_MAGIC = 0x54484545;  // "EEHT"
+const uint32_t HASH_FILE_FORMAT = 1;          // ûʽİ汾ţı"HashStruct""HashItemStruct"ʱҪ1
+const int64_t HASH_FILE_OFFSET = 65536;       // ûļе
+
+struct HashFileHeaderStruct {
+  uint32_t dwMagic, dwFormat;                 // ļʶûʽ
+  uint32_t dwBucketSize, dwHashGen;           // ÿͰֽû
+  uint64_t qwZobristSum;                      // ZobristֵУ
+  int64_t llHashMask;                         // ûͰ1
+};
+
+// ZobristֵУ(FNV-1a)"PreGenInit()"ɵļֵͬʱļûͲ
+static uint64_t ZobristSum(void) {
+  const uint8_t *lpuc;
+  uint64_t qwSum;
+  int i;
+  qwSum = 0xcbf29ce484222325;
+  lpuc = (const uint8_t *) &PreGen.zobrPlayer;
+  for (i = 0; i < (int) sizeof(ZobristStruct); i ++) {
+    qwSum = (qwSum ^ lpuc[i]) * 0x100000001b3;
+  }
+  lpuc = (const uint8_t *) PreGen.zobrTable;
+  for (i = 0; i < (int) sizeof(PreGen.zobrTable); i ++) {
+    qwSum = (qwSum ^ lpuc[i]) * 0x100000001b3;
+  }
+  return qwSum;
+}
+
+/* û浽ļ(̬û)
+ *
+ * ûǴļӳģôҪȸƵڴвӳ䣬
+ * 򱣴浽ͬһļʱļضϺӳڴʧЧˣдݺԺ
+ */
+bool SaveHashFile(const char *szFileName) {
+  HashFileHeaderStruct hfh;
+  FILE *fp;
+  int64_t llSize;
+  void *lp;
+  bool bSuccess;
+
+  WaitHash();
+  llSize = (llHashMask + 1) * sizeof(HashBucketStruct);
+  if (bHashMapped) {
+    lp = LargeAlloc(llSize);
+    if (lp == NULL) {
+      return false;
+    }
+    memcpy(lp, hshBuckets, (size_t) llSize);
+    UnmapFile(hshBuckets, llSize);
+    hshBuckets = (HashBucketStruct *) lp;
+    bHashMapped = false;
+  }
+  fp = fopen(szFileName, "wb");
+  if (fp == NULL) {
+    return false;
+  }
+  memset(&hfh, 0, sizeof(HashFileHeaderStruct));
+  hfh.dwMagic = HASH_FILE_MAGIC;
+  hfh.dwFormat = HASH_FILE_FORMAT;
+  hfh.dwBucketSize = sizeof(HashBucketStruct);
+  hfh.dwHashGen = ucHashGen;
+  hfh.qwZobristSum = ZobristSum();
+  hfh.llHashMask = llHashMask;
+  bSuccess = fwrite(&hfh, sizeof(HashFileHeaderStruct), 1, fp) == 1 &&
+      fseek(fp, (long) HASH_FILE_OFFSET, SEEK_SET) == 0 &&
+      fwrite(hshBuckets, 1, (size_t) llSize, fp) == (size_t) llSize;
+  return fclose(fp) == 0 && bSuccess;
+}
+
+/* ļû
+ *
+ * ûдʱƵķʽӳ䵽ڴģҪȰļһ飬
+ * ʱʵϵͳʹļдݲӰļ
+ * ɹûĴСļԭûͷš
+ */
+bool LoadHashFile(const char *szFileName) {
+  HashFileHeaderStruct hfh;
+  FILE *fp;
+  void *lp;
+  bool bSuccess;
+
+  // 1. ȡļͷ
+  fp = fopen(szFileName, "rb");
+  if (fp == NULL) {
+    return false;
+  }
+  bSuccess = fread(&hfh, sizeof(HashFileHeaderStruct), 1, fp) == 1;
+  fclose(fp);
+  if (!bSuccess || hfh.dwMagic != HASH_FILE_MAGIC || hfh.dwFormat != HASH_FILE_FORMAT ||
+      hfh.dwBucketSize != sizeof(HashBucketStruct) || hfh.qwZobristSum != ZobristSum() ||
+      hfh.llHashMask < 0 || (hfh.llHashMask & (hfh.llHashMask + 1)) != 0) {
+    return false;
+  }
+
+  // 2. ӳû
+  lp = MapFile(szFileName, HASH_FILE_OFFSET, (hfh.llHashMask + 1) * sizeof(HashBucketStruct));
+  if (lp == NULL) {
+    return false;
+  }
+
+  // 3. ӳû滻ԭû
+  DelHash();
+  llHashMask = hfh.llHashMask;
+  hshBuckets = (HashBucketStruct *) lp;
+  ucHashGen = (uint8_t) hfh.dwHashGen;
+  bHashMapped = true;
+  return true;
+}
+
 #endif
 
+// 侲̬ûС 2^nHashScale ֽڣڴ治ʱʹ
+void NewHashQ(int nHashScale) {
+  WaitHash();
+  llHashMaskQ = (((int64_t) 1 << nHashScale) / sizeof(uint64_t)) - 1;
+  lpqwHashQ = (uint64_t *) LargeAlloc((llHashMaskQ + 1) * sizeof(uint64_t));
+  if (lpqwHashQ != NULL) {
+    StartClear(lpqwHashQ, (llHashMaskQ + 1) * sizeof(uint64_t));
+  }
+}
+
+// ͷž̬û
+void DelHashQ(void) {
+  WaitHash();
+  if (lpqwHashQ != NULL) {
+    LargeFree(lpqwHashQ, (llHashMaskQ + 1) * sizeof(uint64_t));
+    lpqwHashQ = NULL;
+  }
+}
+
 // 洢ûϢ
 void RecordHash(const PositionStruct &pos, int nFlag, int vl, int nDepth, int mv) {
   HashStruct hsh;
@@ -60,10 +299,8 @@ void RecordHash(const PositionStruct &pos, int nFlag, int vl, int nDepth, int mv
   nMinDepth = 512;
   nMinLayer = 0;
   for (i = 0; i < HASH_LAYERS; i ++) {
-    hsh = HASH_ITEM(pos, i);
-
     // 3. ̽һľ棬ôûϢɣ
-    if (HASH_POS_EQUAL(hsh, pos)) {
+    if (LoadHash(hsh, HASH_ITEM(pos, i), pos)) {
       // ȸ߽߱Сɸûֵ
       if ((nFlag & HASH_ALPHA) != 0 && (hsh.ucAlphaDepth <= nDepth || hsh.svlAlpha >= vl)) {
         hsh.ucAlphaDepth = nDepth;
@@ -78,14 +315,17 @@ void RecordHash(const PositionStruct &pos, int nFlag, int vl, int nDepth, int mv
       if (mv != 0) {
         hsh.wmv = mv;
       }
-      HASH_ITEM(pos, i) = hsh;
+      StoreHash(HASH_ITEM(pos, i), hsh, pos);
       return;
     }
 
-    // 4. һľ棬ôСû
+    // 4. һľ棬ôСûǰµûȱ滻
     nHashDepth = MAX((hsh.ucAlphaDepth == 0 ? 0 : hsh.ucAlphaDepth + 256),
         (hsh.wmv == 0 ? hsh.ucBetaDepth : hsh.ucBetaDepth + 256));
     __ASSERT(nHashDepth < 512);
+    if (HASH_GEN(HASH_ITEM(pos, i)) != ucHashGen) {
+      nHashDepth -= 512;
+    }
     if (nHashDepth < nMinDepth) {
       nMinDepth = nHashDepth;
       nMinLayer = i;
@@ -93,8 +333,6 @@ void RecordHash(const PositionStruct &pos, int nFlag, int vl, int nDepth, int mv
   }
 
   // 5. ¼û
-  hsh.dwZobristLock0 = pos.zobr.dwLock0;
-  hsh.dwZobristLock1 = pos.zobr.dwLock1;
   hsh.wmv = mv;
   hsh.ucAlphaDepth = hsh.ucBetaDepth = 0;
   hsh.svlAlpha = hsh.svlBeta = 0;
@@ -106,7 +344,7 @@ void RecordHash(const PositionStruct &pos, int nFlag, int vl, int nDepth, int mv
     hsh.ucBetaDepth = nDepth;
     hsh.svlBeta = vl;
   }
-  HASH_ITEM(pos, nMinLayer) = hsh;
+  StoreHash(HASH_ITEM(pos, nMinLayer), hsh, pos);
 }
 
 /* жϻȡûҪЩûķֵĸͬвͬĴ
@@ -177,8 +415,7 @@ static bool PosStable(const PositionStruct &pos, int mv) {
     }
     // ȡûͬ"ProbeHash()"
     for (i = 0; i < HASH_LAYERS; i ++) {
-      hsh = HASH_ITEM(posMutable, i);
-      if (HASH_POS_EQUAL(hsh, posMutable)) {
+      if (LoadHash(hsh, HASH_ITEM(posMutable, i), posMutable)) {
         break;
       }
     }
@@ -200,9 +437,9 @@ int ProbeHash(const PositionStruct &pos, int vlAlpha, int vlBeta, int nDepth, bo
 
   // 1. ȡû
   mv = 0;
+  nHashProbes ++;
   for (i = 0; i < HASH_LAYERS; i ++) {
-    hsh = HASH_ITEM(pos, i);
-    if (HASH_POS_EQUAL(hsh, pos)) {
+    if (LoadHash(hsh, HASH_ITEM(pos, i), pos)) {
       mv = hsh.wmv;
       __ASSERT(mv == 0 || pos.LegalMove(mv));
       break;
@@ -211,6 +448,7 @@ int ProbeHash(const PositionStruct &pos, int vlAlpha, int vlBeta, int nDepth, bo
   if (i == HASH_LAYERS) {
     return -MATE_VALUE;
   }
+  nHashHits ++;
 
   // 2. жǷBeta߽
   if (hsh.ucBetaDepth > 0) {
@@ -236,43 +474,58 @@ int ProbeHash(const PositionStruct &pos, int vlAlpha, int vlBeta, int nDepth, bo
   return -MATE_VALUE;
 }
 
-#ifdef HASH_QUIESC
+// ̬ûеУ16λ͵16λֱĸ16λ
+inline uint64_t HashLockQ(const PositionStruct &pos) {
+  return ((uint64_t) (pos.zobr.dwLock0 >> 16) << 48) | ((uint64_t) (pos.zobr.dwLock0 & 0xffff) << 16);
+}
+
+const uint64_t HASH_LOCK_MASK_Q = 0xffff0000ffff0000;
 
-// 洢ûϢ(̬)
+// 洢ûϢ(̬)ûз侲̬ûʱκ
 void RecordHashQ(const PositionStruct &pos, int vlBeta, int vlAlpha) {
-  volatile HashStruct *lphsh;
   __ASSERT((vlBeta > -WIN_VALUE && vlBeta < WIN_VALUE) || (vlAlpha > -WIN_VALUE && vlAlpha < WIN_VALUE));
-  lphsh = hshItemsQ + (pos.zobr.dwKey & nHashMask);
-  lphsh->dwZobristLock0 = pos.zobr.dwLock0;
-  lphsh->svlAlpha = vlAlpha;
-  lphsh->svlBeta = vlBeta;
-  lphsh->dwZobristLock1 = pos.zobr.dwLock1;
+  if (lpqwHashQ != NULL) {
+    (volatile uint64_t &) HASH_ITEM_Q(pos) = HashLockQ(pos) |
+        ((uint64_t) (uint16_t) vlBeta << 32) | (uint16_t) vlAlpha;
+  }
 }
 
-// ȡûϢ(̬)
+// ȡûϢ(̬)ǰȷѷ侲̬û
 int ProbeHashQ(const PositionStruct &pos, int vlAlpha, int vlBeta) {
-  volatile HashStruct *lphsh;
+  uint64_t qw;
   int vlHashAlpha, vlHashBeta;
 
-  lphsh = hshItemsQ + (pos.zobr.dwKey & nHashMask);
-  if (lphsh->dwZobristLock0 == pos.zobr.dwLock0) {
-    vlHashAlpha = lphsh->svlAlpha;
-    vlHashBeta = lphsh->svlBeta;
-    if (lphsh->dwZobristLock1 == pos.zobr.dwLock1) {
-      if (vlHashBeta >= vlBeta) {
-        __ASSERT(vlHashBeta > -WIN_VALUE && vlHashBeta < WIN_VALUE);
-        return vlHashBeta;
-      }
-      if (vlHashAlpha <= vlAlpha) {
-        __ASSERT(vlHashAlpha > -WIN_VALUE && vlHashAlpha < WIN_VALUE);
-        return vlHashAlpha;
-      }
+  __ASSERT(lpqwHashQ != NULL);
+  qw = (volatile uint64_t &) HASH_ITEM_Q(pos);
+  if ((qw & HASH_LOCK_MASK_Q) == HashLockQ(pos)) {
+    vlHashBeta = (int16_t) (qw >> 32);
+    vlHashAlpha = (int16_t) qw;
+    if (vlHashBeta >= vlBeta) {
+      __ASSERT(vlHashBeta > -WIN_VALUE && vlHashBeta < WIN_VALUE);
+      return vlHashBeta;
+    }
+    if (vlHashAlpha <= vlAlpha) {
+      __ASSERT(vlHashAlpha > -WIN_VALUE && vlHashAlpha < WIN_VALUE);
+      return vlHashAlpha;
     }
   }
   return -MATE_VALUE;
 }
 
-#endif
+// ûռ(ǧֱ)ֻͳƿͷ1000ûеǰ
+int HashFull(void) {
+  int i, nItems, nFull;
+  const HashItemStruct *lphi;
+  nItems = (int) MIN(llHashMask + 1, (int64_t) (HASH_FULL_ITEMS / HASH_LAYERS)) * HASH_LAYERS;
+  nFull = 0;
+  for (i = 0; i < nItems; i ++) {
+    lphi = &hshBuckets[i / HASH_LAYERS].hi[i % HASH_LAYERS];
+    if (lphi->qwData != 0 && HASH_GEN(*lphi) == ucHashGen) {
+      nFull ++;
+    }
+  }
+  return nFull * HASH_FULL_ITEMS / nItems;
+}
 
 #ifndef CCHESS_A3800
 
@@ -281,23 +534,26 @@ bool PopHash(const PositionStruct &pos) {
   HashStruct hsh;
   uint32_t dwMoveStr;
   int i;
+  char *lp;
+  char szLineStr[256];
 
+  WaitHash();
   for (i = 0; i < HASH_LAYERS; i ++) {
-    hsh = HASH_ITEM(pos, i);
-    if (HASH_POS_EQUAL(hsh, pos)) {
-      printf("pophash");
+    if (LoadHash(hsh, HASH_ITEM(pos, i), pos)) {
+      // ʱ̵߳ãƴúһ
+      lp = szLineStr + sprintf(szLineStr, "pophash");
       if (hsh.wmv != 0) {
         __ASSERT(pos.LegalMove(hsh.wmv));
         dwMoveStr = MOVE_COORD(hsh.wmv);
-        printf(" bestmove %.4s", (const char *) &dwMoveStr);
+        lp += sprintf(lp, " bestmove %.4s", (const char *) &dwMoveStr);
       }
       if (hsh.ucBetaDepth > 0) {
-        printf(" lowerbound %d depth %d", hsh.svlBeta, hsh.ucBetaDepth);
+        lp += sprintf(lp, " lowerbound %d depth %d", hsh.svlBeta, hsh.ucBetaDepth);
       }
       if (hsh.ucAlphaDepth > 0) {
-        printf(" upperbound %d depth %d", hsh.svlAlpha, hsh.ucAlphaDepth);
+        lp += sprintf(lp, " upperbound %d depth %d", hsh.svlAlpha, hsh.ucAlphaDepth);
       }
-      printf("\n");
+      printf("%s\n", szLineStr);
       fflush(stdout);
       return true;
     }
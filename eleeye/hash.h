@@ -21,6 +21,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include <string.h>
+#ifdef _MSC_VER
+  #include <xmmintrin.h>
+#endif
 #include "../base/base.h"
 #include "position.h"
 
@@ -32,65 +35,132 @@ const int HASH_BETA = 1;
 const int HASH_ALPHA = 2;
 const int HASH_PV = HASH_ALPHA | HASH_BETA;
 
-const int HASH_LAYERS = 2;   // ûĲ
+const int HASH_LAYERS = 4;   // ûĲ(ÿͰû)
 const int NULL_DEPTH = 2;    // Ųü
+const int HASH_FULL_ITEMS = 1000; // ͳûռʱȡ
 
-// ûṹûϢZobristУм䣬Էֹȡͻ
+// ûϢռ8ֽ
 struct HashStruct {
-  uint32_t dwZobristLock0;           // ZobristУһ
   uint16_t wmv;                      // ŷ
   uint8_t ucAlphaDepth, ucBetaDepth; // (ϱ߽±߽)
   int16_t svlAlpha, svlBeta;         // ֵ(ϱ߽±߽)
-  uint32_t dwZobristLock1;           // ZobristУڶ
 }; // hsh
 
+/* û洢ûϢZobristУֵ
+ * ȡʱ뻹ԭУ߳ͬʱдͬһʱ
+ * д(ֱַԲͬд)ֻᱻУûҪ
+ * ֵĵ8λøûУʵֻõ56λ
+ */
+struct HashItemStruct {
+  uint64_t qwLockXorData;            // УûϢֵ(8λ)
+  uint64_t qwData;                   // ûϢ
+}; // hi
+
+const uint64_t HASH_GEN_MASK = 0xff; // ֵеλ
+
+// ûͰ"HASH_LAYERS"ûռһ64ֽڵĻߣÿֻ̽һλʧЧ
+struct HashBucketStruct {
+  alignas(64) HashItemStruct hi[HASH_LAYERS];
+}; // hb
+
 // ûϢ
-extern int nHashMask;              // ûĴС
-extern HashStruct *hshItems;       // ûָ룬ElephantEyeöû
-#ifdef HASH_QUIESC
-  extern HashStruct *hshItemsQ;
+extern int64_t llHashMask;           // ûĴС(Ͱĸ1)
+extern HashBucketStruct *hshBuckets; // ûָ룬ElephantEyeöû
+extern uint8_t ucHashGen;            // ûÿ1
+
+/* ̬û"qhashsize"ѡǷʹãÿֻ8ֽڣ32λİɣ
+ * ߰ZobristУĸ16λϱ߽磬ͰУĵ16λ±߽硣
+ * 64λƽ̨һ64λĶдᱻд32λƽ̨Ҫζдܶͬİƴɵ
+ * ÿԴһУУͨС
+ */
+extern int64_t llHashMaskQ;          // ̬ûĴС(1)
+extern uint64_t *lpqwHashQ;          // ̬ûָ룬ʹʱΪNULL
+
+// û̽дۻļһֲ߳̾ģÿ߳㲢
+extern thread_local int nHashProbes;
+extern thread_local int nHashHits;
+
+void ClearHash(void);                 // û(ں̨)
+void WaitHash(void);                  // ȴû
+void NewHash(int nHashScale);         // ûС 2^nHashScale ֽ
+void DelHash(void);                   // ͷû
+#ifndef CCHESS_A3800
+bool SaveHashFile(const char *szFileName); // û浽ļ
+bool LoadHashFile(const char *szFileName); // ļû(ӳķʽ)
 #endif
+void NewHashQ(int nHashScale);        // 侲̬ûС 2^nHashScale ֽ
+void DelHashQ(void);                  // ͷž̬û
 
-inline void ClearHash(void) {         // û
-  memset(hshItems, 0, (nHashMask + 1) * sizeof(HashStruct));
-#ifdef HASH_QUIESC
-  memset(hshItemsQ, 0, (nHashMask + 1) * sizeof(HashStruct));
-#endif
+inline void NewHashGen(void) {        // ʼµû1
+  ucHashGen ++;
 }
 
-inline void NewHash(int nHashScale) { // ûС 2^nHashScale ֽ
-  nHashMask = ((1 << nHashScale) / sizeof(HashStruct)) - 1;
-  hshItems = new HashStruct[nHashMask + 1];
-#ifdef HASH_QUIESC
-  hshItemsQ = new HashStruct[nHashMask + 1];
-#endif
-  ClearHash();
+// 64λZobristУ
+inline uint64_t HASH_LOCK(const PositionStruct &pos) {
+  return ((uint64_t) pos.zobr.dwLock1 << 32) | pos.zobr.dwLock0;
+}
+
+// ûеû2^32ͰʱҪУһ
+inline uint64_t HASH_KEY(const PositionStruct &pos) {
+  return ((uint64_t) pos.zobr.dwLock1 << 32) | pos.zobr.dwKey;
 }
 
-inline void DelHash(void) {           // ͷû
-  delete[] hshItems;
-#ifdef HASH_QUIESC
-  delete[] hshItemsQ;
+// Ͳȡû
+inline HashItemStruct &HASH_ITEM(const PositionStruct &pos, int nLayer) {
+  return hshBuckets[HASH_KEY(pos) & llHashMask].hi[nLayer];
+}
+
+// ȡ̬û
+inline uint64_t &HASH_ITEM_Q(const PositionStruct &pos) {
+  return lpqwHashQ[HASH_KEY(pos) & llHashMaskQ];
+}
+
+#ifdef HASH_PREFETCH
+// ԤȡڵͰ"MakeMove()"Zobristֵãȵ"ProbeHash()"ʱͰѾڻ
+inline void PrefetchHash(const PositionStruct &pos) {
+#ifdef _MSC_VER
+  _mm_prefetch((const char *) &hshBuckets[HASH_KEY(pos) & llHashMask], _MM_HINT_T0);
+  if (lpqwHashQ != NULL) {
+    _mm_prefetch((const char *) &HASH_ITEM_Q(pos), _MM_HINT_T0);
+  }
+#else
+  __builtin_prefetch(&hshBuckets[HASH_KEY(pos) & llHashMask]);
+  if (lpqwHashQ != NULL) {
+    __builtin_prefetch(&HASH_ITEM_Q(pos));
+  }
 #endif
 }
+#endif
+
+// û
+inline int HASH_GEN(const HashItemStruct &hi) {
+  return (int) (hi.qwLockXorData & HASH_GEN_MASK);
+}
 
-// жûǷϾ(ZobristǷ)
-inline bool HASH_POS_EQUAL(const HashStruct &hsh, const PositionStruct &pos) {
-  return hsh.dwZobristLock0 == pos.zobr.dwLock0 && hsh.dwZobristLock1 == pos.zobr.dwLock1;
+// ȡûǷжûϢֻзϾ(Zobrist)ʱŷ"true"
+inline bool LoadHash(HashStruct &hsh, const HashItemStruct &hi, const PositionStruct &pos) {
+  uint64_t qwData, qwLockXorData;
+  // 64λֵԶȡһΣһ߳Ƿд룬ֻдǰдֵ
+  qwData = ((const volatile HashItemStruct &) hi).qwData;
+  qwLockXorData = ((const volatile HashItemStruct &) hi).qwLockXorData;
+  memcpy(&hsh, &qwData, sizeof(HashStruct));
+  return ((qwData ^ qwLockXorData) & ~HASH_GEN_MASK) == (HASH_LOCK(pos) & ~HASH_GEN_MASK);
 }
 
-// Ͳȡû(һãԶ丳ֵ)
-inline HashStruct &HASH_ITEM(const PositionStruct &pos, int nLayer) {
-  return hshItems[(pos.zobr.dwKey + nLayer) & nHashMask];
+// дûͬʱϵǰ
+inline void StoreHash(HashItemStruct &hi, const HashStruct &hsh, const PositionStruct &pos) {
+  uint64_t qwData;
+  memcpy(&qwData, &hsh, sizeof(HashStruct));
+  ((volatile HashItemStruct &) hi).qwData = qwData;
+  ((volatile HashItemStruct &) hi).qwLockXorData = ((qwData ^ HASH_LOCK(pos)) & ~HASH_GEN_MASK) | ucHashGen;
 }
 
 // ûĹ
 void RecordHash(const PositionStruct &pos, int nFlag, int vl, int nDepth, int mv);                    // 洢ûϢ
 int ProbeHash(const PositionStruct &pos, int vlAlpha, int vlBeta, int nDepth, bool bNoNull, int &mv); // ȡûϢ
-#ifdef HASH_QUIESC
-  void RecordHashQ(const PositionStruct &pos, int vlBeta, int vlAlpha); // 洢ûϢ(̬)
-  int ProbeHashQ(const PositionStruct &pos, int vlAlpha, int vlBeta);   // ȡûϢ(̬)
-#endif
+void RecordHashQ(const PositionStruct &pos, int vlBeta, int vlAlpha);                              // 洢ûϢ(̬)
+int ProbeHashQ(const PositionStruct &pos, int vlAlpha, int vlBeta);                                 // ȡûϢ(̬)
+int HashFull(void);                                                                                 // ûռ(ǧֱ)
 
 #ifndef CCHESS_A3800
   // UCCI֧ - HashеľϢ
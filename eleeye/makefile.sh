@@ -1 +1 @@
-g++ -DNDEBUG -O4 -Wall -oELEEYE.EXE ../base/pipe.cpp ucci.cpp pregen.cpp position.cpp genmoves.cpp hash.cpp book.cpp movesort.cpp preeval.cpp evaluate.cpp search.cpp eleeye.cpp
\ No newline at end of file
+g++ -DNDEBUG -O4 -Wall -oELEEYE.EXE ../base/pipe.cpp ucci.cpp pregen.cpp position.cpp genmoves.cpp hash.cpp book.cpp movesort.cpp preeval.cpp evaluate.cpp search.cpp perft.cpp eleeye.cpp -lpthread
\ No newline at end of file
@@ -24,25 +24,117 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "position.h"
 #include "movesort.h"
 
-int nHistory[65536]; // ʷ
+thread_local int nHistory[65536]; // ʷ
+thread_local int16_t nContHistory[2][CONT_PREV_NUM][CONT_MOVE_NUM]; // ʷ
 
-// ʷŷбֵ
-void MoveSortStruct::SetHistory(void) {
-  int i, j, vl, nShift, nNewShift;
-  nShift = 0;
+// 90̸е
+inline int SQUARE_INDEX(int sq) {
+  return (RANK_Y(sq) - RANK_TOP) * 9 + FILE_X(sq) - FILE_LEFT;
+}
+
+// ʷеǰŷͺĿ
+inline int CONT_MOVE_INDEX(int pc, int sq) {
+  return PIECE_TYPE(pc) * 90 + SQUARE_INDEX(sq);
+}
+
+// ʷǰһŷ(ֺ)Ŀ
+inline int CONT_PREV_INDEX(int pc, int sq) {
+  return (PIECE_TYPE(pc) + ((pc & 32) == 0 ? 0 : 7)) * 90 + SQUARE_INDEX(sq);
+}
+
+/* ʷһУ"nPly"Ϊ1ʱӦʷΪ2ʱǺʷ
+ *
+ * ǰһŷӾĿϣǰŷӿѾԷԵʱĿǶԷӣ
+ * źʼ涼ûǰһŷЩNULL
+ */
+static int16_t *ContHistory(const PositionStruct &pos, int nPly) {
+  int mv, pc;
+  if (pos.nMoveNum < nPly) {
+    return NULL;
+  }
+  mv = pos.rbsList[pos.nMoveNum - nPly].mvs.wmv;
+  if (mv == 0) {
+    return NULL;
+  }
+  pc = pos.ucpcSquares[DST(mv)];
+  if ((pc & SIDE_TAG(nPly == 1 ? OPP_SIDE(pos.sdPlayer) : pos.sdPlayer)) == 0) {
+    return NULL;
+  }
+  return nContHistory[nPly - 1][CONT_PREV_INDEX(pc, DST(mv))];
+}
+
+/* ʷʷŷбֵ
+ *
+ * űķֵ"HISTORY_MAX"֮䣬"HISTORY_MAX * 3 + 1"1"HISTORY_MAX * 6 + 1"֮䣬
+ * ûŷɱŷķֵͻ
+ */
+void MoveSortStruct::SetHistory(const PositionStruct &pos) {
+  int i, mv, vl, nIndex;
+  const int16_t *lpnCont1, *lpnCont2;
+  lpnCont1 = ContHistory(pos, 1);
+  lpnCont2 = ContHistory(pos, 2);
   for (i = nMoveIndex; i < nMoveNum; i ++) {
-    // ŷķֵ65536ͱŷķֵʹǶ65536
-    vl = nHistory[mvs[i].wmv] >> nShift;
-    if (vl > 65535) {
-      nNewShift = Bsr(vl) - 15;
-      for (j = nMoveIndex; j < i; j ++) {
-        mvs[j].wvl >>= nNewShift;
+    mv = mvs[i].wmv;
+    vl = nHistory[mv];
+    nIndex = CONT_MOVE_INDEX(pos.ucpcSquares[SRC(mv)], DST(mv));
+    if (lpnCont1 != NULL) {
+      vl += lpnCont1[nIndex];
+    }
+    if (lpnCont2 != NULL) {
+      vl += lpnCont2[nIndex];
+    }
+    __ASSERT_BOUND(-HISTORY_MAX * 3, vl, HISTORY_MAX * 3);
+    mvs[i].wvl = vl + HISTORY_MAX * 3 + 1;
+  }
+}
+
+/* ""ʽʷֵ
+ *
+ * ӷֻ۷ֵķֵӽ޶СֵԶᳬ"HISTORY_MAX"
+ * µϢܸıŷ˳򣬲Ҫʷ
+ */
+template <typename T> inline void UpdateHistory(T &vl, int nBonus) {
+  vl += nBonus - vl * ABS(nBonus) / HISTORY_MAX;
+}
+
+/* ҵŷʱȡĴʩ
+ *
+ * ʷ¼ѡ
+ * 1. ƽϵ(n^2)
+ * 2. ָϵ(2^n)
+ * 3. FibonacciУ
+ * 4. ϼϣ磺n^2 + 2^nȵȡ
+ * ElephantEyeʹͳƽϵŷӷ֣֮ǰĲŷ("lpwmvQuiets")۷֣
+ * ʷӦʷͺʷͬʱ¡
+ */
+void SetBestMove(const PositionStruct &pos, int mv, int nDepth, uint16_t *lpwmvKiller, const uint16_t *lpwmvQuiets, int nQuiets) {
+  int i, mvQuiet, nBonus;
+  int16_t *lpnCont1, *lpnCont2;
+  nBonus = MIN(SQR(nDepth), HISTORY_MAX / 8);
+  lpnCont1 = ContHistory(pos, 1);
+  lpnCont2 = ContHistory(pos, 2);
+  UpdateHistory(nHistory[mv], nBonus);
+  if (lpnCont1 != NULL) {
+    UpdateHistory(lpnCont1[CONT_MOVE_INDEX(pos.ucpcSquares[SRC(mv)], DST(mv))], nBonus);
+  }
+  if (lpnCont2 != NULL) {
+    UpdateHistory(lpnCont2[CONT_MOVE_INDEX(pos.ucpcSquares[SRC(mv)], DST(mv))], nBonus);
+  }
+  for (i = 0; i < nQuiets; i ++) {
+    mvQuiet = lpwmvQuiets[i];
+    if (mvQuiet != mv) {
+      UpdateHistory(nHistory[mvQuiet], -nBonus);
+      if (lpnCont1 != NULL) {
+        UpdateHistory(lpnCont1[CONT_MOVE_INDEX(pos.ucpcSquares[SRC(mvQuiet)], DST(mvQuiet))], -nBonus);
+      }
+      if (lpnCont2 != NULL) {
+        UpdateHistory(lpnCont2[CONT_MOVE_INDEX(pos.ucpcSquares[SRC(mvQuiet)], DST(mvQuiet))], -nBonus);
       }
-      vl >>= nNewShift;
-      __ASSERT_BOUND(32768, vl, 65535);
-      nShift += nNewShift;
     }
-    mvs[i].wvl = vl;
+  }
+  if (lpwmvKiller[0] != mv) {
+    lpwmvKiller[1] = lpwmvKiller[0];
+    lpwmvKiller[0] = mv;
   }
 }
 
@@ -78,36 +170,26 @@ void MoveSortStruct::ShellSort(void) {
  * 1. ûŷ(SORT_VALUE_MAX)
  * 2. ɱŷ(SORT_VALUE_MAX - 12)
  * 3. ŷʷ(1SORT_VALUE_MAX - 3)
- * 4. ܽ⽫ŷ(0)Щŷ˵
+ * ܽ⽫ŷʱȥ("GenLegalMoves()")ʣµŷʱ"PickBest()"ѡ
  */
 int MoveSortStruct::InitEvade(PositionStruct &pos, int mv, const uint16_t *lpwmvKiller) {
-  int i, nLegal;
+  int i;
   nPhase = PHASE_REST;
   nMoveIndex = 0;
-  nMoveNum = pos.GenAllMoves(mvs);
-  SetHistory();
-  nLegal = 0;
+  nMoveNum = pos.GenLegalMoves(mvs);
+  SetHistory(pos);
   for (i = nMoveIndex; i < nMoveNum; i ++) {
     if (mvs[i].wmv == mv) {
-      nLegal ++;
       mvs[i].wvl = SORT_VALUE_MAX;
-    } else if (pos.MakeMove(mvs[i].wmv)) {
-      pos.UndoMakeMove();
-      nLegal ++;
-      if (mvs[i].wmv == lpwmvKiller[0]) {
-        mvs[i].wvl = SORT_VALUE_MAX - 1;
-      } else if (mvs[i].wmv == lpwmvKiller[1]) {
-        mvs[i].wvl = SORT_VALUE_MAX - 2;
-      } else {
-        mvs[i].wvl = MIN(mvs[i].wvl + 1, SORT_VALUE_MAX - 3);
-      }
+    } else if (mvs[i].wmv == lpwmvKiller[0]) {
+      mvs[i].wvl = SORT_VALUE_MAX - 1;
+    } else if (mvs[i].wmv == lpwmvKiller[1]) {
+      mvs[i].wvl = SORT_VALUE_MAX - 2;
     } else {
-      mvs[i].wvl = 0;
+      mvs[i].wvl = MIN(mvs[i].wvl + 1, SORT_VALUE_MAX - 3);
     }
   }
-  ShellSort();
-  nMoveNum = nMoveIndex + nLegal;
-  return (nLegal == 1 ? mvs[0].wmv : 0);
+  return (nMoveNum == 1 ? mvs[0].wmv : 0);
 }
 
 // һŷ
@@ -129,15 +211,17 @@ int MoveSortStruct::NextFull(const PositionStruct &pos) {
     nPhase = PHASE_GOODCAP;
     nMoveIndex = 0;
     nMoveNum = pos.GenCapMoves(mvs);
-    ShellSort();
 
-  // 2. MVV(LVA)ҪѭɴΣ
+  // 2. MVV(LVA)ҪѭɴΣÿֻѡһֵߵĳŷ
   case PHASE_GOODCAP:
-    if (nMoveIndex < nMoveNum && mvs[nMoveIndex].wvl > 1) {
-      // ע⣺MVV(LVA)ֵ1˵ӲֱܻƵģЩŷԺ
-      nMoveIndex ++;
-      __ASSERT_PIECE(pos.ucpcSquares[DST(mvs[nMoveIndex - 1].wmv)]);
-      return mvs[nMoveIndex - 1].wmv;
+    if (nMoveIndex < nMoveNum) {
+      PickBest();
+      if (mvs[nMoveIndex].wvl > 1) {
+        // ע⣺MVV(LVA)ֵ1˵ӲֱܻƵģЩŷԺ
+        nMoveIndex ++;
+        __ASSERT_PIECE(pos.ucpcSquares[DST(mvs[nMoveIndex - 1].wmv)]);
+        return mvs[nMoveIndex - 1].wmv;
+      }
     }
 
   // 3. ɱŷ(һɱŷ)ɺһ׶Σ
@@ -159,12 +243,12 @@ int MoveSortStruct::NextFull(const PositionStruct &pos) {
   case PHASE_GEN_NONCAP:
     nPhase = PHASE_REST;
     nMoveNum += pos.GenNonCapMoves(mvs + nMoveNum);
-    SetHistory();
-    ShellSort();
+    SetHistory(pos);
 
-  // 6. ʣŷʷ(ؽ⽫ŷ)
+  // 6. ʣŷʷ(ؽ⽫ŷ)ͬÿֻѡһֵߵŷ
   case PHASE_REST:
     if (nMoveIndex < nMoveNum) {
+      PickBest();
       nMoveIndex ++;
       return mvs[nMoveIndex - 1].wmv;
     }
@@ -176,10 +260,10 @@ int MoveSortStruct::NextFull(const PositionStruct &pos) {
 }
 
 // ɸŷ
-void MoveSortStruct::InitRoot(const PositionStruct &pos, int nBanMoves, const uint16_t *lpwmvBanList) {
+void MoveSortStruct::InitRoot(PositionStruct &pos, int nBanMoves, const uint16_t *lpwmvBanList) {
   int i, j, nBanned;
   nMoveIndex = 0;
-  nMoveNum = pos.GenAllMoves(mvs);
+  nMoveNum = pos.GenLegalMoves(mvs);
   nBanned = 0;
   for (i = 0; i < nMoveNum; i ++) {
     mvs[i].wvl = 1;
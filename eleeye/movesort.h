@@ -32,8 +32,14 @@ const int SORT_VALUE_MAX = 65535; // 
 
 extern const int FIBONACCI_LIST[32];
 
-// "nHistory"ֻ"movesort.cpp"һģʹ
-extern int nHistory[65536]; // ʷ
+const int HISTORY_MAX = 8192;     // ʷֵޣʷ""ʽ£ֵ֮
+const int CONT_PREV_NUM = 1260;   // ʷǰһŷ˫14ӳ90
+const int CONT_MOVE_NUM = 630;    // ʷеǰŷ7ӳ90
+
+// "nHistory""nContHistory"ֻ"movesort.cpp"һģʹãÿ̸߳һ
+extern thread_local int nHistory[65536]; // ʷ
+// ʷһάΪ0ʱӦʷ(ǰһǶԷŷ)Ϊ1ʱǺʷ(ǰǱŷ)
+extern thread_local int16_t nContHistory[2][CONT_PREV_NUM][CONT_MOVE_NUM];
 
 // ŷ˳ɽ׶("NextFull()")
 const int PHASE_HASH = 0;
@@ -53,8 +59,22 @@ struct MoveSortStruct {
   int mvHash, mvKiller1, mvKiller2;
   MoveStruct mvs[MAX_GEN_MOVES];
 
-  void SetHistory(void); // ʷŷбֵ
-  void ShellSort(void);  // ŷ
+  void SetHistory(const PositionStruct &pos); // ʷʷŷбֵ
+  void ShellSort(void);  // ỵֻ̂ڸ
+  // ѡ̣ʣŷзֵߵŷ"nMoveIndex"λϣֻҪŷҪ
+  void PickBest(void) {
+    int i, nBest;
+    MoveStruct mvsBest;
+    nBest = nMoveIndex;
+    for (i = nMoveIndex + 1; i < nMoveNum; i ++) {
+      if (mvs[i].wvl > mvs[nBest].wvl) {
+        nBest = i;
+      }
+    }
+    mvsBest = mvs[nBest];
+    mvs[nBest] = mvs[nMoveIndex];
+    mvs[nMoveIndex] = mvsBest;
+  }
   // õĳŷ(ûŷʷɱŷ)
   bool GoodCap(const PositionStruct &pos, int mv) {
     return mv == 0 || nPhase == PHASE_GOODCAP || (nPhase < PHASE_GOODCAP && pos.GoodCap(mv));
@@ -64,26 +84,25 @@ struct MoveSortStruct {
   void InitAll(const PositionStruct &pos) {
     nMoveIndex = 0;
     nMoveNum = pos.GenAllMoves(mvs);
-    SetHistory();
-    ShellSort();
+    SetHistory(pos);
   }
   void InitQuiesc(const PositionStruct &pos) {
     nMoveIndex = 0;
     nMoveNum = pos.GenCapMoves(mvs);
-    ShellSort();
   }
   void InitQuiesc2(const PositionStruct &pos) {
     nMoveNum += pos.GenNonCapMoves(mvs);
-    SetHistory();
-    ShellSort();
+    SetHistory(pos);
   }
   int NextQuiesc(bool bNextAll = false) {
-    if (nMoveIndex < nMoveNum && (bNextAll || mvs[nMoveIndex].wvl > 0)) {
-      nMoveIndex ++;
-      return mvs[nMoveIndex - 1].wmv;
-    } else {
-      return 0;
+    if (nMoveIndex < nMoveNum) {
+      PickBest();
+      if (bNextAll || mvs[nMoveIndex].wvl > 0) {
+        nMoveIndex ++;
+        return mvs[nMoveIndex - 1].wmv;
+      }
     }
+    return 0;
   }
 
   // ȫŷ˳
@@ -97,7 +116,7 @@ struct MoveSortStruct {
   int NextFull(const PositionStruct &pos);
 
   // ŷ˳
-  void InitRoot(const PositionStruct &pos, int nBanMoves, const uint16_t *lpwmvBanList);
+  void InitRoot(PositionStruct &pos, int nBanMoves, const uint16_t *lpwmvBanList);
   void ResetRoot(bool bUnique = false) {
     nMoveIndex = 0;
     ShellSort();
@@ -114,9 +133,21 @@ struct MoveSortStruct {
   void UpdateRoot(int mv);
 };
 
-// ʷ
+// ʷʷ
 inline void ClearHistory(void) {
   memset(nHistory, 0, sizeof(int[65536]));
+  memset(nContHistory, 0, sizeof(nContHistory));
+}
+
+/* ʷ˥ÿʼʱãǰһϢ
+ *
+ * ʷ""ʽĸ£ֵᳬޣҲͲҪ˥
+ */
+inline void AgeHistory(void) {
+  int i;
+  for (i = 0; i < 65536; i ++) {
+    nHistory[i] /= 2;
+  }
 }
 
 // ɱŷ
@@ -129,21 +160,7 @@ inline void CopyKiller(uint16_t (*lpwmvDst)[2], const uint16_t (*lpwmvSrc)[2]) {
   memcpy(lpwmvDst, lpwmvSrc, LIMIT_DEPTH * sizeof(uint16_t[2]));
 }
      
-/* ҵŷʱȡĴʩ
- *
- * ʷ¼ѡ
- * 1. ƽϵ(n^2)
- * 2. ָϵ(2^n)
- * 3. FibonacciУ
- * 4. ϼϣ磺n^2 + 2^nȵȡ
- * ElephantEyeʹͳƽϵ
- */
-inline void SetBestMove(int mv, int nDepth, uint16_t *lpwmvKiller) {
-  nHistory[mv] += SQR(nDepth);
-  if (lpwmvKiller[0] != mv) {
-    lpwmvKiller[1] = lpwmvKiller[0];
-    lpwmvKiller[0] = mv;
-  }
-}
+// ҵŷʱȡĴʩ
+void SetBestMove(const PositionStruct &pos, int mv, int nDepth, uint16_t *lpwmvKiller, const uint16_t *lpwmvQuiets, int nQuiets);
 
 #endif
@@ -0,0 +1,214 @@
+/*
+perft.h/perft.cpp - Source Code for ElephantEye, Part XII
+
+ElephantEye - a Chinese Chess Program (UCCI Engine)
+Copyright (C) 2026 ElephantEye contributors
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../base/base.h"
+#include "../base/base2.h"
+#include "pregen.h"
+#include "position.h"
+#include "hash.h"
+#include "perft.h"
+
+/* ֲ(Perft)ͳƴһɲܵҶӽŷ"MakeMove()"ȷԣ
+ * ͬʱǵٶȣŷĺϷԺʱһ"GenAllMoves()"ɺ"MakeMove()"жϡ
+ *
+ * ֲûÿ16ֽڣݵĸ8λȣ56λǽ洢ʱZobristУ
+ * ȡʱ64λֵԶȡһΣ߳ͬʱдҲõĽ("hash.h"е"LoadHash()")
+ */
+struct PerftHashStruct {
+  uint64_t qwLockXorData, qwData;
+};
+
+static int64_t llPerftHashMask;
+static PerftHashStruct *lpPerftHash = NULL;
+
+const uint64_t PERFT_NODES_MASK = ((uint64_t) 1 << 56) - 1;
+
+// ֲûС 2^nHashScale ֽ
+void NewPerftHash(int nHashScale) {
+  llPerftHashMask = (((int64_t) 1 << nHashScale) / sizeof(PerftHashStruct)) - 1;
+  lpPerftHash = (PerftHashStruct *) LargeAlloc((llPerftHashMask + 1) * sizeof(PerftHashStruct));
+  if (lpPerftHash != NULL) {
+    memset(lpPerftHash, 0, (llPerftHashMask + 1) * sizeof(PerftHashStruct));
+  }
+}
+
+// ͷŷֲû
+void DelPerftHash(void) {
+  if (lpPerftHash != NULL) {
+    LargeFree(lpPerftHash, (llPerftHashMask + 1) * sizeof(PerftHashStruct));
+    lpPerftHash = NULL;
+  }
+}
+
+// ֲûʱȴ1Ľ㶼ҪҺͼ¼û
+int64_t Perft(PositionStruct &pos, int nDepth) {
+  int i, nGenNum;
+  int64_t llNodes;
+  uint64_t qwData, qwLockXorData;
+  PerftHashStruct *lpph;
+  MoveStruct mvs[MAX_GEN_MOVES];
+
+  if (nDepth == 0) {
+    return 1;
+  }
+  lpph = NULL;
+  if (lpPerftHash != NULL && nDepth > 1) {
+    lpph = lpPerftHash + (HASH_KEY(pos) & llPerftHashMask);
+    qwData = ((volatile PerftHashStruct *) lpph)->qwData;
+    qwLockXorData = ((volatile PerftHashStruct *) lpph)->qwLockXorData;
+    if ((qwData ^ qwLockXorData) == HASH_LOCK(pos) && (int) (qwData >> 56) == nDepth) {
+      return (int64_t) (qwData & PERFT_NODES_MASK);
+    }
+  }
+  llNodes = 0;
+  nGenNum = pos.GenAllMoves(mvs);
+  for (i = 0; i < nGenNum; i ++) {
+    if (pos.MakeMove(mvs[i].wmv)) {
+      llNodes += Perft(pos, nDepth - 1);
+      pos.UndoMakeMove();
+    }
+  }
+  if (lpph != NULL) {
+    qwData = ((uint64_t) nDepth << 56) | ((uint64_t) llNodes & PERFT_NODES_MASK);
+    ((volatile PerftHashStruct *) lpph)->qwData = qwData;
+    ((volatile PerftHashStruct *) lpph)->qwLockXorData = qwData ^ HASH_LOCK(pos);
+  }
+  return llNodes;
+}
+
+/* ̵߳ķֲĵiŷɵ(i % nThreads)̼߳
+ * 0߳̾ǵ̺߱߳ĸ߳һɺ"bBusy"־
+ */
+static struct {
+  int nDepth, nThreads, nMoveNum;
+  MoveStruct mvs[MAX_GEN_MOVES];
+  int64_t llNodes[MAX_GEN_MOVES];
+} PerftRootInfo;
+
+static struct {
+  volatile bool bBusy;
+  PositionStruct pos;
+} PerftThreads[PERFT_MAX_THREADS];
+
+static void *PerftHelper(void *lpParameter) {
+  int i, nThreadId;
+  nThreadId = (int) (intptr_t) lpParameter;
+  for (i = nThreadId; i < PerftRootInfo.nMoveNum; i += PerftRootInfo.nThreads) {
+    PerftThreads[nThreadId].pos.MakeMove(PerftRootInfo.mvs[i].wmv);
+    PerftRootInfo.llNodes[i] = Perft(PerftThreads[nThreadId].pos, PerftRootInfo.nDepth - 1);
+    PerftThreads[nThreadId].pos.UndoMakeMove();
+  }
+  PerftThreads[nThreadId].bBusy = false;
+  return NULL;
+}
+
+// Ѹŷֲָ߳"bDivide"ʾÿŷĽ
+int64_t PerftRoot(const PositionStruct &pos, int nDepth, int nThreads, bool bDivide) {
+  int i;
+  int64_t llNodes;
+  uint32_t dwMoveStr;
+
+  if (nDepth == 0) {
+    return 1;
+  }
+  // 1. ɸĺϷŷ
+  PerftThreads[0].pos = pos;
+  PerftRootInfo.nDepth = nDepth;
+  PerftRootInfo.nMoveNum = PerftThreads[0].pos.GenLegalMoves(PerftRootInfo.mvs);
+  PerftRootInfo.nThreads = MAX(MIN(MIN(nThreads, PERFT_MAX_THREADS), PerftRootInfo.nMoveNum), 1);
+
+  // 2. ̣߳߳ԼҲ
+  for (i = 1; i < PerftRootInfo.nThreads; i ++) {
+    PerftThreads[i].pos = pos;
+    PerftThreads[i].bBusy = true;
+    // ޷߳ʱ߳Լ̵߳ŷ
+    if (!StartThread(PerftHelper, (void *) (intptr_t) i)) {
+      PerftHelper((void *) (intptr_t) i);
+    }
+  }
+  PerftHelper((void *) (intptr_t) 0);
+  for (i = 1; i < PerftRootInfo.nThreads; i ++) {
+    while (PerftThreads[i].bBusy) {
+      Idle();
+    }
+  }
+
+  // 3. ܽŷɵ˳ÿŷĽ
+  llNodes = 0;
+  for (i = 0; i < PerftRootInfo.nMoveNum; i ++) {
+    llNodes += PerftRootInfo.llNodes[i];
+    if (bDivide) {
+      dwMoveStr = MOVE_COORD(PerftRootInfo.mvs[i].wmv);
+      printf("info divide %.4s nodes %lld\n", (const char *) &dwMoveStr, (long long) PerftRootInfo.llNodes[i]);
+    }
+  }
+  if (bDivide) {
+    fflush(stdout);
+  }
+  return llNodes;
+}
+
+/* ֪ľ棬ʼͼս(н⽫˧()ͺܶ)
+ * ȵĽ"GenAllMoves()""MakeMove()"ķ"GenLegalMoves()"ĽҲһ¡
+ */
+const int PERFT_SUITE_NUM = 5;
+const int PERFT_SUITE_MAX_DEPTH = 5;
+
+static const struct {
+  const char *szFen;
+  int64_t llNodes[PERFT_SUITE_MAX_DEPTH];
+} PerftSuiteList[PERFT_SUITE_NUM] = {
+  {"rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w", {44, 1920, 79666, 3290240, 133312995}},
+  {"r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w", {38, 1128, 43929, 1339047, 53112976}},
+  {"1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w", {7, 281, 8620, 326201, 10369923}},
+  {"5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w", {25, 424, 9850, 202884, 4739553}},
+  {"CRN1k1b2/3ca4/4ba3/9/2nr5/9/9/4B4/4A4/4KA3 w", {28, 516, 14808, 395483, 11842230}}
+};
+
+// ֪ľֲȳ֪ʱȡ֪
+bool PerftSuite(int nDepth, int nThreads) {
+  int i, nTime;
+  int64_t llNodes, llAllNodes, llTime;
+  bool bCorrect, bAllCorrect;
+  PositionStruct pos;
+
+  nDepth = MIN(MAX(nDepth, 1), PERFT_SUITE_MAX_DEPTH);
+  llAllNodes = 0;
+  bAllCorrect = true;
+  llTime = GetTime();
+  for (i = 0; i < PERFT_SUITE_NUM; i ++) {
+    pos.FromFen(PerftSuiteList[i].szFen);
+    llNodes = PerftRoot(pos, nDepth, nThreads, false);
+    bCorrect = (llNodes == PerftSuiteList[i].llNodes[nDepth - 1]);
+    printf("info perft position %d depth %d nodes %lld %s\n", i + 1, nDepth, (long long) llNodes,
+        bCorrect ? "ok" : "error");
+    fflush(stdout);
+    llAllNodes += llNodes;
+    bAllCorrect = bAllCorrect && bCorrect;
+  }
+  nTime = (int) (GetTime() - llTime);
+  printf("info perft nodes %lld time %d nps %lld %s\n", (long long) llAllNodes, nTime,
+      (long long) (llAllNodes * 1000 / MAX(nTime, 1)), bAllCorrect ? "ok" : "error");
+  fflush(stdout);
+  return bAllCorrect;
+}
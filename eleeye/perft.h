@@ -0,0 +1,38 @@
+/*
+perft.h/perft.cpp - Source Code for ElephantEye, Part XII
+
+ElephantEye - a Chinese Chess Program (UCCI Engine)
+Copyright (C) 2026 ElephantEye contributors
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "../base/base.h"
+#include "position.h"
+
+#ifndef PERFT_H
+#define PERFT_H
+
+const int PERFT_MAX_THREADS = 32;   // ָŷ߳
+const int PERFT_HASH_SCALE = 26;    // ֲûĬϴС(64MB)
+const int PERFT_SUITE_DEPTH = 4;    // ֪ľĬϼ
+
+void NewPerftHash(int nHashScale);  // ֲûС 2^nHashScale ֽ
+void DelPerftHash(void);            // ͷŷֲû
+int64_t Perft(PositionStruct &pos, int nDepth); // ֲ
+int64_t PerftRoot(const PositionStruct &pos, int nDepth, int nThreads, bool bDivide); // Ѹŷֲָ߳
+bool PerftSuite(int nDepth, int nThreads);      // ֪ľֲȫʱ"true"
+
+#endif
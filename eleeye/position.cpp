@@ -23,6 +23,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../base/base.h"
 #include "pregen.h"
 #include "position.h"
+#ifdef HASH_PREFETCH
+  #include "hash.h"
+#endif
 
 /* ElephantEyeԴʹõǺԼ
  *
@@ -146,6 +149,7 @@ void PositionStruct::AddPiece(int sq, int pc, bool bDel) {
   }
   __ASSERT_BOUND(0, pt, 13);
   this->zobr.Xor(PreGen.zobrTable[pt][sq]);
+  this->bbPieces[pt].Xor(PreGen.bbSquareMask[sq]);
 }
 
 // ƶ
@@ -186,10 +190,11 @@ int PositionStruct::MovePiece(int mv) {
     }
     __ASSERT_BOUND(0, pt, 13);
     this->zobr.Xor(PreGen.zobrTable[pt][sqDst]);
+    this->bbPieces[pt].Xor(PreGen.bbSquareMask[sqDst]);
   }
 
   // 4. "ucpcSquares""ucsqPieces"ƶӣע⡰-ϵ顱ƶӵķ
-  //    ͬʱλСλСֵλλСZobristֵУ
+  //    ͬʱλСλСֵλλСZobristֵУλ
   this->ucpcSquares[sqSrc] = 0;
   this->ucpcSquares[sqDst] = pcMoved;
   this->ucsqPieces[pcMoved] = sqDst;
@@ -208,6 +213,7 @@ int PositionStruct::MovePiece(int mv) {
   }
   __ASSERT_BOUND(0, pt, 13);
   this->zobr.Xor(PreGen.zobrTable[pt][sqDst], PreGen.zobrTable[pt][sqSrc]);
+  this->bbPieces[pt].Xor(PreGen.bbSquareMask[sqDst], PreGen.bbSquareMask[sqSrc]);
   return pcCaptured;
 }
 
@@ -226,11 +232,13 @@ void PositionStruct::UndoMovePiece(int mv, int pcCaptured) {
   this->wBitFiles[FILE_X(sqSrc)] ^= PreGen.wBitFileMask[sqSrc];
   __ASSERT_BITRANK(this->wBitRanks[RANK_Y(sqSrc)]);
   __ASSERT_BITFILE(this->wBitRanks[FILE_X(sqSrc)]);
+  this->bbPieces[PIECE_BITBOARD(pcMoved)].Xor(PreGen.bbSquareMask[sqDst], PreGen.bbSquareMask[sqSrc]);
   if (pcCaptured > 0) {
     __ASSERT_PIECE(pcCaptured);
     this->ucpcSquares[sqDst] = pcCaptured;
     this->ucsqPieces[pcCaptured] = sqDst;
     this->dwBitPiece ^= BIT_PIECE(pcCaptured);
+    this->bbPieces[PIECE_BITBOARD(pcCaptured)].Xor(PreGen.bbSquareMask[sqDst]);
   } else {
     this->ucpcSquares[sqDst] = 0;
     this->wBitRanks[RANK_Y(sqDst)] ^= PreGen.wBitRankMask[sqDst];
@@ -267,6 +275,7 @@ int PositionStruct::Promote(int sq) {
   }
   __ASSERT_BOUND(0, pt, 13);
   this->zobr.Xor(PreGen.zobrTable[pt][sq]);
+  this->bbPieces[pt].Xor(PreGen.bbSquareMask[sq]);
 
   // 3. ӣͬʱֵZobristֵУ
   this->ucpcSquares[sq] = pcPromoted;
@@ -280,6 +289,7 @@ int PositionStruct::Promote(int sq) {
   }
   __ASSERT_BOUND(0, pt, 13);
   this->zobr.Xor(PreGen.zobrTable[pt][sq]);
+  this->bbPieces[pt].Xor(PreGen.bbSquareMask[sq]);
   return pcCaptured;
 }
 
@@ -294,15 +304,61 @@ void PositionStruct::UndoPromote(int sq, int pcCaptured) {
   this->ucpcSquares[sq] = pcCaptured;
   this->ucsqPieces[pcCaptured] = sq;
   this->dwBitPiece ^= BIT_PIECE(pcPromoted) ^ BIT_PIECE(pcCaptured);
+  this->bbPieces[PIECE_BITBOARD(pcPromoted)].Xor(PreGen.bbSquareMask[sq]);
+  this->bbPieces[PIECE_BITBOARD(pcCaptured)].Xor(PreGen.bbSquareMask[sq]);
 }
 
 // һЩ̴
 
 // һЩŷ
 
+/* жŷǷܸı˧()ı״̬
+ *
+ * ں˧()ֻ˧()ڵлнڼҲֻһлһϣ˧()бڸ
+ * ʼĿ񶼲˧()ڵкϣʼҲ˧()бڸŷ򿪻ڵκν·
+ * ŷֻƶӱܽͱ()()λҲ˧()ڵлϡ
+ */
+inline bool KING_LINE(int sqKing, int sq) {
+  return RANK_Y(sq) == RANK_Y(sqKing) || FILE_X(sq) == FILE_X(sqKing);
+}
+
+inline bool AffectKing(int sqKing, int sqSrc, int sqDst) {
+  return KING_LINE(sqKing, sqSrc) || KING_LINE(sqKing, sqDst) || ADVISOR_SPAN(sqSrc, sqKing);
+}
+
+/* жŷִк˧()Ƿȫ
+ *
+ * ûбƶĲ˧()ŷͱ˧()ûйϵô϶ȫ
+ * ֻƶӺһν(˧())ؽӷҲؼ¼ŷ
+ * "MakeMove()"һﵽŷʱжΪǷŷ"SaveStatus()"дعб⡣
+ */
+bool PositionStruct::MoveSafe(int mv) {
+  int sqSrc, sqDst, sqKing, pcCaptured;
+  bool bSafe;
+  if (this->nMoveNum == MAX_MOVE_NUM) {
+    return false;
+  }
+  sqSrc = SRC(mv);
+  sqDst = DST(mv);
+  sqKing = this->ucsqPieces[SIDE_TAG(this->sdPlayer) + KING_FROM];
+  if (sqSrc == sqDst || sqKing == 0) {
+    return true;
+  }
+  if (LastMove().ChkChs <= 0 && sqSrc != sqKing && !AffectKing(sqKing, sqSrc, sqDst)) {
+    return true;
+  }
+  SaveStatus();
+  pcCaptured = MovePiece(mv);
+  bSafe = (CheckedBy(CHECK_LAZY) == 0);
+  UndoMovePiece(mv, pcCaptured);
+  Rollback();
+  return bSafe;
+}
+
 // ִһŷ
 bool PositionStruct::MakeMove(int mv) {
-  int sq, pcCaptured;
+  int sq, sqKing, pcCaptured, pcMoved;
+  bool bSafe;
   uint32_t dwOldZobristKey;
   RollbackStruct *lprbs;
 
@@ -317,15 +373,20 @@ bool PositionStruct::MakeMove(int mv) {
   dwOldZobristKey = this->zobr.dwKey;
   SaveStatus();
 
-  // 2. ƶӣסԵ(еĻ)
+  // 2. ƶӣסԵ(еĻ)ƶǰжŷǷ϶Ϸ
+  //    ûбƶĲ˧()ŷͱ˧()ûйϵ("AffectKing()")ôƶ󲻻ᱻ
   sq = SRC(mv);
+  pcMoved = this->ucpcSquares[sq];
   if (sq == DST(mv)) {
     pcCaptured = Promote(sq);
   } else {
+    sqKing = this->ucsqPieces[SIDE_TAG(this->sdPlayer) + KING_FROM];
+    bSafe = sqKing == 0 || (LastMove().ChkChs <= 0 && pcMoved != SIDE_TAG(this->sdPlayer) + KING_FROM &&
+        !AffectKing(sqKing, sq, DST(mv)));
     pcCaptured = MovePiece(mv);
 
     // 3. ƶ󱻽ˣôŷǷǷģŷ
-    if (CheckedBy(CHECK_LAZY) > 0) {
+    if (!bSafe && CheckedBy(CHECK_LAZY) > 0) {
       UndoMovePiece(mv, pcCaptured);
       Rollback();
       return false;
@@ -334,21 +395,34 @@ bool PositionStruct::MakeMove(int mv) {
 
   // 4. ӷ
   ChangeSide();
+#ifdef HASH_PREFETCH
+  // ZobristֵѾ£ԤȡûĽ׽жϿڸڴӳ
+  PrefetchHash(*this);
+#endif
 
   // 5. ԭZobristֵ¼ظû
   if (this->ucRepHash[dwOldZobristKey & REP_HASH_MASK] == 0) {
     this->ucRepHash[dwOldZobristKey & REP_HASH_MASK] = this->nMoveNum;
   }
 
-  // 6. ŷ浽ʷŷбУסԵӺͽ״̬
+  // 6. ŷ浽ʷŷбУסԵӺͽ״̬
+  //    ֻкͶԷ˧()йϵŷԼܽλϵҪ
   lprbs = this->rbsList + this->nMoveNum;
   lprbs->mvs.wmv = mv;
-  lprbs->mvs.ChkChs = CheckedBy();
+  sqKing = this->ucsqPieces[SIDE_TAG(this->sdPlayer) + KING_FROM];
+  if (sqKing == 0) {
+    lprbs->mvs.ChkChs = 0;
+  } else if (sq == DST(mv) || AffectKing(sqKing, sq, DST(mv)) ||
+      (PIECE_TYPE(pcMoved) == KNIGHT_TYPE && KNIGHT_PIN(DST(mv), sqKing) != DST(mv))) {
+    lprbs->mvs.ChkChs = CheckedBy();
+  } else {
+    lprbs->mvs.ChkChs = 0;
+  }
 
-  // 7. úŷ(Ӧ)
+  // 7. úŷ(Ӧ)"׽"ļƳٵظʱ
   if (pcCaptured == 0) {
     if (lprbs->mvs.ChkChs == 0) {
-      lprbs->mvs.ChkChs = -ChasedBy(mv);
+      lprbs->mvs.ChkChs = CHASE_LAZY;
     }
     if (LastMove().CptDrw == -100) {
       lprbs->mvs.CptDrw = -100;
@@ -396,6 +470,9 @@ void PositionStruct::NullMove(void) {
   }
   SaveStatus();
   ChangeSide();
+#ifdef HASH_PREFETCH
+  PrefetchHash(*this);
+#endif
   this->rbsList[nMoveNum].mvs.dwmv = 0; // wmv, Chk, CptDrw, ChkChs = 0
   this->nMoveNum ++;
   this->nDistance ++;
@@ -413,6 +490,40 @@ void PositionStruct::UndoNullMove(void) {
   __ASSERT(this->nMoveNum > 0);
 }
 
+// "׽"ļ⣬ѵ"nMoveFrom"ŷԺƳټ"ChkChs"
+void PositionStruct::SetChase(int nMoveFrom) {
+  int i, nMoveNum;
+  int vlWhiteList[MAX_MOVE_NUM + 1], vlBlackList[MAX_MOVE_NUM + 1];
+  nMoveNum = this->nMoveNum;
+  // 1. ҵһƳټŷ֮ǰŷس
+  while (nMoveFrom < nMoveNum && this->rbsList[nMoveFrom].mvs.ChkChs != CHASE_LAZY) {
+    nMoveFrom ++;
+  }
+  if (nMoveFrom == nMoveNum) {
+    return;
+  }
+  /* 2. ŷ֮ǰһִУÿִһŷ"׽"ļ⣻
+   * ǰŷǰԤִеģִеõֵ᲻ͬҪָԭֵ
+   */
+  for (i = nMoveFrom + 1; i < nMoveNum; i ++) {
+    vlWhiteList[i] = this->rbsList[i].vlWhite;
+    vlBlackList[i] = this->rbsList[i].vlBlack;
+  }
+  vlWhiteList[nMoveNum] = this->vlWhite;
+  vlBlackList[nMoveNum] = this->vlBlack;
+  for (i = nMoveFrom; i < nMoveNum; i ++) {
+    UndoMakeMove();
+  }
+  for (i = nMoveFrom; i < nMoveNum; i ++) {
+    MakeMove(this->rbsList[i].mvs.wmv);
+    this->vlWhite = vlWhiteList[i + 1];
+    this->vlBlack = vlBlackList[i + 1];
+    if (LastMove().ChkChs == CHASE_LAZY) {
+      this->rbsList[i].mvs.ChkChs = -ChasedBy(LastMove().wmv);
+    }
+  }
+}
+
 // һЩŷ
 
 // һЩ洦
@@ -686,13 +797,15 @@ bool PositionStruct::LegalMove(int mv) const {
   }
 }
 
-// 
+/* 
+ *
+ * ܳԵ˧()ĶԷӲһλУڵĹΧ˧()λкλе"wRookCap""wCannonCap"õ
+ * ֻûʱܽλеλжǷӽ
+ */
 int PositionStruct::CheckedBy(bool bLazy) const {
-  int pcCheckedBy, i, sqSrc, sqDst, sqPin, pc, x, y, nOppSideTag;
+  int i, sqSrc, x, y, nOppBitBoard;
   SlideMaskStruct *lpsmsRank, *lpsmsFile;
-
-  pcCheckedBy = 0;
-  nOppSideTag = OPP_SIDE_TAG(this->sdPlayer);
+  BitBoardStruct bbCheckers, bbKnights;
   // жϰ¼ݣ
 
   // 1. ж˧()Ƿ
@@ -701,6 +814,7 @@ int PositionStruct::CheckedBy(bool bLazy) const {
     return 0;
   }
   __ASSERT_SQUARE(sqSrc);
+  nOppBitBoard = OPP_SIDE(this->sdPlayer) * 7;
 
   // 2. ˧()ڸӵλкλ
   x = FILE_X(sqSrc);
@@ -708,103 +822,40 @@ int PositionStruct::CheckedBy(bool bLazy) const {
   lpsmsRank = RankMaskPtr(x, y);
   lpsmsFile = FileMaskPtr(x, y);
 
-  // 3. жǷ˧
-  sqDst = this->ucsqPieces[nOppSideTag + KING_FROM];
-  if (sqDst != 0) {
-    __ASSERT_SQUARE(sqDst);
-    if (x == FILE_X(sqDst) && (lpsmsFile->wRookCap & PreGen.wBitFileMask[sqDst]) != 0) {
-      return CHECK_MULTI;
-    }
+  // 3. жǷ˧򱻳
+  bbCheckers = SlideBitBoard(x, y, lpsmsRank->wRookCap, lpsmsFile->wRookCap);
+  if (!(bbCheckers & this->bbPieces[nOppBitBoard + KING_TYPE]).IsZero()) {
+    return CHECK_MULTI;
   }
+  bbCheckers = bbCheckers & this->bbPieces[nOppBitBoard + ROOK_TYPE];
 
-  // 4. жǷ
-  for (i = KNIGHT_FROM; i <= KNIGHT_TO; i ++) {
-    sqDst = this->ucsqPieces[nOppSideTag + i];
-    if (sqDst != 0) {
-      __ASSERT_SQUARE(sqDst);
-      sqPin = KNIGHT_PIN(sqDst, sqSrc); // ע⣬sqSrcsqDstǷģ
-      if (sqPin != sqDst && this->ucpcSquares[sqPin] == 0) {
-        if (bLazy || pcCheckedBy > 0) {
-          return CHECK_MULTI;
-        }
-        pcCheckedBy = nOppSideTag + i;
-        __ASSERT_PIECE(pcCheckedBy);
-      }
-    }
-  }
+  // 4. жǷڽ
+  bbCheckers = bbCheckers | (SlideBitBoard(x, y, lpsmsRank->wCannonCap, lpsmsFile->wCannonCap) &
+      this->bbPieces[nOppBitBoard + CANNON_TYPE]);
 
-  // 5. жǷ񱻳˧
-  for (i = ROOK_FROM; i <= ROOK_TO; i ++) {
-    sqDst = this->ucsqPieces[nOppSideTag + i];
-    if (sqDst != 0) {
-      __ASSERT_SQUARE(sqDst);
-      if (x == FILE_X(sqDst)) {
-        if ((lpsmsFile->wRookCap & PreGen.wBitFileMask[sqDst]) != 0) {
-          if (bLazy || pcCheckedBy > 0) {
-            return CHECK_MULTI;
-          }
-          pcCheckedBy = nOppSideTag + i;
-          __ASSERT_PIECE(pcCheckedBy);
-        }
-      } else if (y == RANK_Y(sqDst)) {
-        if ((lpsmsRank->wRookCap & PreGen.wBitRankMask[sqDst]) != 0) {
-          if (bLazy || pcCheckedBy > 0) {
-            return CHECK_MULTI;
-          }
-          pcCheckedBy = nOppSideTag + i;
-          __ASSERT_PIECE(pcCheckedBy);
-        }
+  // 5. жǷ˧()бڸ
+  bbKnights = this->bbPieces[nOppBitBoard + KNIGHT_TYPE];
+  if (!bbKnights.IsZero()) {
+    for (i = 0; i < 4; i ++) {
+      if (this->ucpcSquares[sqSrc + cnDiagonalTab[i]] == 0) {
+        bbCheckers = bbCheckers | (PreGen.bbKnightAttackTab[sqSrc][i] & bbKnights);
       }
     }
   }
 
-  // 6. жǷڽ
-  for (i = CANNON_FROM; i <= CANNON_TO; i ++) {
-    sqDst = this->ucsqPieces[nOppSideTag + i];
-    if (sqDst != 0) {
-      __ASSERT_SQUARE(sqDst);
-      if (x == FILE_X(sqDst)) {
-        if ((lpsmsFile->wCannonCap & PreGen.wBitFileMask[sqDst]) != 0) {
-          if (bLazy || pcCheckedBy > 0) {
-            return CHECK_MULTI;
-          }
-          pcCheckedBy = nOppSideTag + i;
-          __ASSERT_PIECE(pcCheckedBy);
-        }
-      } else if (y == RANK_Y(sqDst)) {
-        if ((lpsmsRank->wCannonCap & PreGen.wBitRankMask[sqDst]) != 0) {
-          if (bLazy || pcCheckedBy > 0) {
-            return CHECK_MULTI;
-          }
-          pcCheckedBy = nOppSideTag + i;
-          __ASSERT_PIECE(pcCheckedBy);
-        }
-      }
-    }
-  }
+  // 6. жǷ񱻱()
+  bbCheckers = bbCheckers | (PreGen.bbPawnAttackTab[OPP_SIDE(this->sdPlayer)][sqSrc] &
+      this->bbPieces[nOppBitBoard + PAWN_TYPE]);
 
-  // 7. жǷ񱻱()
-  for (sqDst = sqSrc - 1; sqDst <= sqSrc + 1; sqDst += 2) {
-    // ˧()ڱ(ElephantEye)ôԲ
-    // __ASSERT_SQUARE(sqDst);
-    pc = this->ucpcSquares[sqDst];
-    if ((pc & nOppSideTag) != 0 && PIECE_INDEX(pc) >= PAWN_FROM) {
-      if (bLazy || pcCheckedBy > 0) {
-        return CHECK_MULTI;
-      }
-      pcCheckedBy = nOppSideTag + i;
-      __ASSERT_PIECE(pcCheckedBy);
-    }
-  }
-  pc = this->ucpcSquares[SQUARE_FORWARD(sqSrc, this->sdPlayer)];
-  if ((pc & nOppSideTag) != 0 && PIECE_INDEX(pc) >= PAWN_FROM) {
-    if (bLazy || pcCheckedBy > 0) {
-      return CHECK_MULTI;
-    }
-    pcCheckedBy = nOppSideTag + i;
-    __ASSERT_PIECE(pcCheckedBy);
+  // 7. ݽؽ
+  if (bbCheckers.IsZero()) {
+    return 0;
+  } else if (bLazy || bbCheckers.IsMulti()) {
+    return CHECK_MULTI;
+  } else {
+    __ASSERT_PIECE(this->ucpcSquares[bbCheckers.LowSquare()]);
+    return this->ucpcSquares[bbCheckers.LowSquare()];
   }
-  return pcCheckedBy;
 }
 
 // жǷ񱻽
@@ -813,16 +864,14 @@ bool PositionStruct::IsMate(void) {
   MoveStruct mvsGen[MAX_GEN_MOVES];
   nGenNum = GenCapMoves(mvsGen);
   for (i = 0; i < nGenNum; i ++) {
-    if (MakeMove(mvsGen[i].wmv)) {
-      UndoMakeMove();
+    if (MoveSafe(mvsGen[i].wmv)) {
       return false;
     }
   }
   // ŷɷԽԼʱ
   nGenNum = GenNonCapMoves(mvsGen);
   for (i = 0; i < nGenNum; i ++) {
-    if (MakeMove(mvsGen[i].wmv)) {
-      UndoMakeMove();
+    if (MoveSafe(mvsGen[i].wmv)) {
       return false;
     }
   }
@@ -841,11 +890,11 @@ inline void SetPerpCheck(uint32_t &dwPerpCheck, int nChkChs) {
 }
 
 // ظ
-int PositionStruct::RepStatus(int nRecur) const {
+int PositionStruct::RepStatus(int nRecur) {
   // "nRecur"ָظȡ1Ч(Ĭֵ)㴦ȡ3Ӧ
   int sd;
   uint32_t dwPerpCheck, dwOppPerpCheck;
-  const RollbackStruct *lprbs;
+  const RollbackStruct *lprbs, *lprbsRep;
   /* ظ¼裺
    *
    * 1. жϼظûǷеǰ棬ûпܣòж
@@ -858,37 +907,38 @@ int PositionStruct::RepStatus(int nRecur) const {
     return REP_NONE;
   }
 
-  // 2. ʼ
+  // 2. Ѱظ棬ŻŷͲظ
   sd = OPP_SIDE(this->sdPlayer);
-  dwPerpCheck = dwOppPerpCheck = 0x1ffff;
-  lprbs = this->rbsList + this->nMoveNum - 1;
-
-  // 3. һŷǿŻŷͲظ
-  while (lprbs->mvs.wmv != 0 && lprbs->mvs.CptDrw <= 0) {
-    __ASSERT(lprbs >= this->rbsList);
-
-    // 4. ж˫ĳ򼶱0ʾ޳0xffffʾ׽0x10000ʾ
-    if (sd == this->sdPlayer) {
-      SetPerpCheck(dwPerpCheck, lprbs->mvs.ChkChs);
-
-      // 5. Ѱظ棬ظﵽԤ򷵻ظǺ
-      if (lprbs->zobr.dwLock0 == this->zobr.dwLock0 && lprbs->zobr.dwLock1 == this->zobr.dwLock1) {
-        nRecur --;
-        if (nRecur == 0) {
-          dwPerpCheck = ((dwPerpCheck & 0xffff) == 0 ? dwPerpCheck : 0xffff);
-          dwOppPerpCheck = ((dwOppPerpCheck & 0xffff) == 0 ? dwOppPerpCheck : 0xffff);
-          return dwPerpCheck > dwOppPerpCheck ? REP_LOSS : dwPerpCheck < dwOppPerpCheck ? REP_WIN : REP_DRAW;
-        }
+  lprbsRep = this->rbsList + this->nMoveNum - 1;
+  while (lprbsRep->mvs.wmv != 0 && lprbsRep->mvs.CptDrw <= 0) {
+    __ASSERT(lprbsRep >= this->rbsList);
+    if (sd == this->sdPlayer && lprbsRep->zobr.dwLock0 == this->zobr.dwLock0 &&
+        lprbsRep->zobr.dwLock1 == this->zobr.dwLock1) {
+      nRecur --;
+      if (nRecur == 0) {
+        break;
       }
-
-    } else {
-      SetPerpCheck(dwOppPerpCheck, lprbs->mvs.ChkChs);
     }
+    sd = OPP_SIDE(sd);
+    lprbsRep --;
+  }
+  if (nRecur > 0) {
+    return REP_NONE;
+  }
+
+  // 3. ظﵽԤҪѭƳٵ"׽"ļ
+  SetChase(lprbsRep - this->rbsList);
 
+  // 4. ж˫ĳ򼶱0ʾ޳0xffffʾ׽0x10000ʾ
+  sd = OPP_SIDE(this->sdPlayer);
+  dwPerpCheck = dwOppPerpCheck = 0x1ffff;
+  for (lprbs = this->rbsList + this->nMoveNum - 1; lprbs >= lprbsRep; lprbs --) {
+    SetPerpCheck(sd == this->sdPlayer ? dwPerpCheck : dwOppPerpCheck, lprbs->mvs.ChkChs);
     sd = OPP_SIDE(sd);
-    lprbs --;
   }
-  return REP_NONE;
+  dwPerpCheck = ((dwPerpCheck & 0xffff) == 0 ? dwPerpCheck : 0xffff);
+  dwOppPerpCheck = ((dwOppPerpCheck & 0xffff) == 0 ? dwOppPerpCheck : 0xffff);
+  return dwPerpCheck > dwOppPerpCheck ? REP_LOSS : dwPerpCheck < dwOppPerpCheck ? REP_WIN : REP_DRAW;
 }
 
 // һЩŷ
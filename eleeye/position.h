@@ -53,6 +53,12 @@ const int NULLOKAY_MARGIN = 200;        // 
 const int NULLSAFE_MARGIN = 400;        // ʹÿŲüֵ߽
 const int DRAW_VALUE = 20;              // ʱصķ(ȡֵ)
 
+// ͵۵ı߽("evaluate.cpp")еЧü굶üҲõЩ߽
+const int EVAL_MARGIN1 = 160;
+const int EVAL_MARGIN2 = 80;
+const int EVAL_MARGIN3 = 40;
+const int EVAL_MARGIN4 = 20;
+
 const bool CHECK_LAZY = true;   // ͵⽫
 const int CHECK_MULTI = 48;     // ӽ
 
@@ -148,6 +154,10 @@ inline int PIECE_TYPE(int pc) {
   return cnPieceTypes[pc];
 }
 
+inline int PIECE_BITBOARD(int pc) { // λ̵ţ"PositionStruct::bbPieces"±
+  return PIECE_TYPE(pc) + (pc < 32 ? 0 : 7);
+}
+
 inline int SIMPLE_VALUE(int pc) {
   return cnSimpleValues[pc];
 }
@@ -171,6 +181,9 @@ union MoveStruct {
   };
 }; // mvs
 
+// "ChkChs"ֵʾҲŷû"׽"ļ⣬ֻгظʱҪ("RepStatus()")
+const int CHASE_LAZY = -128;
+
 // ŷṹ
 inline int SRC(int mv) { // õŷ
   return mv & 255;
@@ -241,6 +254,7 @@ struct PositionStruct {
   };
   uint16_t wBitRanks[16];   // λ飬ע÷"wBitRanks[RANK_Y(sq)]"
   uint16_t wBitFiles[16];   // λ飬ע÷"wBitFiles[FILE_X(sq)]"
+  BitBoardStruct bbPieces[14]; // ÿӵλ̣ź"zobrTable"һ06Ǻ췽713Ǻڷ
 
   // 
   int vlWhite, vlBlack;   // 췽ͺڷֵ
@@ -273,6 +287,7 @@ struct PositionStruct {
     dwBitPiece = 0;
     memset(wBitRanks, 0, 16 * sizeof(uint16_t));
     memset(wBitFiles, 0, 16 * sizeof(uint16_t));
+    memset(bbPieces, 0, 14 * sizeof(BitBoardStruct));
     vlWhite = vlBlack = 0;
     // "ClearBoard()""SetIrrev()"ʼԱ
   }
@@ -301,10 +316,12 @@ struct PositionStruct {
   void UndoPromote(int sq, int pcCaptured);         // 
 
   // ŷ
+  bool MoveSafe(int mv);   // жŷִк˧()Ƿȫִŷ
   bool MakeMove(int mv);   // ִһŷ
   void UndoMakeMove(void); // һŷ
   void NullMove(void);     // ִһ
   void UndoNullMove(void); // һ
+  void SetChase(int nMoveFrom); // "׽"ļ
   void SetIrrev(void) {    // Ѿɡ桱عŷ
     rbsList[0].mvs.dwmv = 0; // wmv, Chk, CptDrw, ChkChs = 0
     rbsList[0].mvs.ChkChs = CheckedBy();
@@ -320,7 +337,7 @@ struct PositionStruct {
 
   // ŷ
   bool GoodCap(int mv) const {     // õĳŷ⣬ŷ¼ʷɱŷ
-    int pcMoved, pcCaptured;
+    int pcCaptured;
     pcCaptured = ucpcSquares[DST(mv)];
     if (pcCaptured == 0) {
       return false;
@@ -328,8 +345,7 @@ struct PositionStruct {
     if (!Protected(OPP_SIDE(sdPlayer), DST(mv))) {
       return true;
     }
-    pcMoved = ucpcSquares[SRC(mv)];
-    return SIMPLE_VALUE(pcCaptured) > SIMPLE_VALUE(pcMoved);
+    return See(mv) > 0;
   }
   bool LegalMove(int mv) const;            // ŷԼ⣬ڡɱŷļ
   int CheckedBy(bool bLazy = false) const; // ĸӽ
@@ -350,7 +366,7 @@ struct PositionStruct {
     return (!PreEval.bPromotion && (dwBitPiece & BOTH_BITPIECE(ATTACK_BITPIECE)) == 0) ||
         -LastMove().CptDrw >= DRAW_MOVES || nMoveNum == MAX_MOVE_NUM;
   }
-  int RepStatus(int nRecur = 1) const;     // ظ
+  int RepStatus(int nRecur = 1);           // ظ
   int DrawValue(void) const {              // ķֵ
     return (nDistance & 1) == 0 ? -DRAW_VALUE : DRAW_VALUE;
   }
@@ -366,7 +382,8 @@ struct PositionStruct {
   // ŷɹ̣Щ̴ر԰Ƕ"genmoves.cpp"
   bool Protected(int sd, int sqSrc, int sqExcept = 0) const; // ӱж
   int ChasedBy(int mv) const;                                // ׽ĸ
-  int MvvLva(int sqDst, int pcCaptured, int nLva) const;     // MVV(LVA)ֵ
+  int See(int mv) const;                                     // ̬
+  int MvvLva(int sqSrc, int sqDst, int pcCaptured, int nLva) const; // MVV(LVA)ֵ
   int GenCapMoves(MoveStruct *lpmvs) const;                  // ŷ
   int GenNonCapMoves(MoveStruct *lpmvs) const;               // ŷ
   int GenAllMoves(MoveStruct *lpmvs) const {                 // ȫŷ
@@ -374,6 +391,7 @@ struct PositionStruct {
     nCapNum = GenCapMoves(lpmvs);
     return nCapNum + GenNonCapMoves(lpmvs + nCapNum);
   }
+  int GenLegalMoves(MoveStruct *lpmvs);                      // Ϸŷ
 
   // ŷɹ̣Щ̴ر԰Ƕ"preeval.cpp""evaluate.cpp"
   void PreEvaluate(void);
@@ -347,6 +347,9 @@ void PositionStruct::PreEvaluate(void) {
   int i, sq, nMidgameValue, nWhiteAttacks, nBlackAttacks, nWhiteSimpleValue, nBlackSimpleValue;
   uint8_t ucvlPawnPiecesAttacking[256], ucvlPawnPiecesAttackless[256];
 
+  // Ԥݸıˣۻǰݶ
+  dwEvalCacheSalt ++;
+
   if (!bInit) {
     bInit = true;
     // ʼ"PreEvalEx.cPopCnt16"飬ֻҪʼһ
@@ -31,4 +31,24 @@ extern struct PreEvalStructEx {
   char cPopCnt16[65536]; // PopCnt16飬ֻҪʼһ
 } PreEvalEx;
 
+/* ۻ("evaluate.cpp")"evalcache"ѡС(KBΪλ)ÿֻ8ֽڣ32λİɣ
+ * ߰ZobristУ("dwEvalCacheSalt")ĸ16λֵͰУĵ16λ͵۵ĲΡ
+ * ÿԴһУ32λƽ̨Ϸдʹһ߳дҲͨУ飬ԲҪ
+ * ֵ"PreEvaluate()"õԤݣÿԤ۶Ҫı"dwEvalCacheSalt"ʹǰĻʧЧ
+ */
+extern uint32_t dwEvalCacheMask;            // ۻĴС(1)
+extern uint64_t *lpqwEvalCache;             // ۻָ룬ʹʱΪNULL
+extern uint32_t dwEvalCacheSalt;            // ۻУҪֵ
+extern thread_local int nEvalCacheProbes;   // ߳̽ۻĴ
+extern thread_local int nEvalCacheHits;     // ߳ۻĴ
+
+/* ͵ĸηصͳ("evaluate.cpp")0ֻƽ⣬4ȫۣ
+ * ۻļһֲ߳̾ģÿ߳㲢
+ */
+const int EVAL_STAGE_NUM = 5;
+extern thread_local int nEvalStageExits[EVAL_STAGE_NUM]; // ߳ڸηصĴ
+
+void NewEvalCache(int nCacheScale);         // ۻ棬С 2^nCacheScale ֽ
+void DelEvalCache(void);                    // ͷۻ
+
 #endif
@@ -189,6 +189,27 @@ void PreGenInit(void) {
     }
   }
 
+  // Ȼʼλ̵λԼλתλ̵
+  for (sqSrc = 0; sqSrc < 256; sqSrc ++) {
+    PreGen.bbSquareMask[sqSrc].InitZero();
+    if (IN_BOARD(sqSrc)) {
+      n = (RANK_Y(sqSrc) - RANK_TOP) % 5 * 9 + FILE_X(sqSrc) - FILE_LEFT;
+      if (RANK_Y(sqSrc) - RANK_TOP < 5) {
+        PreGen.bbSquareMask[sqSrc].qwLow = (uint64_t) 1 << n;
+      } else {
+        PreGen.bbSquareMask[sqSrc].qwHigh = (uint64_t) 1 << n;
+      }
+    }
+  }
+  for (i = 0; i < 32; i ++) {
+    PreGen.qwFileBitsTab[i] = 0;
+    for (j = 0; j < 5; j ++) {
+      if ((i & (1 << j)) != 0) {
+        PreGen.qwFileBitsTab[i] |= (uint64_t) 1 << (j * 9);
+      }
+    }
+  }
+
   // ȻɳںԤ(Ӧò"pregen.h")
   for (i = 0; i < 9; i ++) {
     for (j = 0; j < 512; j ++) {
@@ -405,6 +426,64 @@ void PreGenInit(void) {
     }
   }
 
+  // λ̵Ԥ飬ܳԵĳӵӵλ
+  for (sqDst = 0; sqDst < 256; sqDst ++) {
+    PreGen.bbKingAttackTab[sqDst].InitZero();
+    PreGen.bbAdvisorAttackTab[sqDst].InitZero();
+    for (i = 0; i < 4; i ++) {
+      PreGen.bbBishopAttackTab[sqDst][i].InitZero();
+      PreGen.bbKnightAttackTab[sqDst][i].InitZero();
+    }
+    PreGen.bbPawnAttackTab[0][sqDst].InitZero();
+    PreGen.bbPawnAttackTab[1][sqDst].InitZero();
+    if (!IN_BOARD(sqDst)) {
+      continue;
+    }
+    for (i = 0; i < 4; i ++) {
+      if (IN_FORT(sqDst)) {
+        sqSrc = sqDst + cnKingMoveTab[i];
+        if (IN_FORT(sqSrc)) {
+          PreGen.bbKingAttackTab[sqDst].Xor(PreGen.bbSquareMask[sqSrc]);
+        }
+        sqSrc = sqDst + cnAdvisorMoveTab[i];
+        if (IN_FORT(sqSrc)) {
+          PreGen.bbAdvisorAttackTab[sqDst].Xor(PreGen.bbSquareMask[sqSrc]);
+        }
+      }
+      sqSrc = sqDst + cnBishopMoveTab[i];
+      if (IN_BOARD(sqSrc) && SAME_HALF(sqSrc, sqDst)) {
+        __ASSERT(BISHOP_PIN(sqSrc, sqDst) == sqDst + cnDiagonalTab[i]);
+        PreGen.bbBishopAttackTab[sqDst][i].Xor(PreGen.bbSquareMask[sqSrc]);
+      }
+      // Ŀбڸȵһλ
+      k = sqDst + cnDiagonalTab[i];
+      sqSrc = k + (cnDiagonalTab[i] > 0 ? 16 : -16);
+      if (IN_BOARD(sqSrc)) {
+        __ASSERT(KNIGHT_PIN(sqSrc, sqDst) == k);
+        PreGen.bbKnightAttackTab[sqDst][i].Xor(PreGen.bbSquareMask[sqSrc]);
+      }
+      sqSrc = k + ((cnDiagonalTab[i] & 15) == 1 ? 1 : -1);
+      if (IN_BOARD(sqSrc)) {
+        __ASSERT(KNIGHT_PIN(sqSrc, sqDst) == k);
+        PreGen.bbKnightAttackTab[sqDst][i].Xor(PreGen.bbSquareMask[sqSrc]);
+      }
+    }
+    for (i = 0; i < 2; i ++) {
+      sqSrc = SQUARE_BACKWARD(sqDst, i);
+      if (IN_BOARD(sqSrc)) {
+        PreGen.bbPawnAttackTab[i][sqDst].Xor(PreGen.bbSquareMask[sqSrc]);
+      }
+      if (AWAY_HALF(sqDst, i)) {
+        for (j = -1; j <= 1; j += 2) {
+          sqSrc = sqDst + j;
+          if (IN_BOARD(sqSrc)) {
+            PreGen.bbPawnAttackTab[i][sqDst].Xor(PreGen.bbSquareMask[sqSrc]);
+          }
+        }
+      }
+    }
+  }
+
   // վԤ۽ṹ
   memset(&PreEval, 0, sizeof(PreEvalStruct));
   PreEval.bPromotion = false; // ȱʡǲ
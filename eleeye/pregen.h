@@ -151,6 +151,59 @@ inline int FILE_DISP(int x) {
   return x;
 }
 
+/* 90ӵλ
+ *
+ * ̰зֳ룬37з"qwLow"У812з"qwHigh"Уÿռ9λ
+ * (x, y)Ӧеĵ"(y - RANK_TOP) % 5 * 9 + (x - FILE_LEFT)"λÿֻõ45λ
+ * еĺôǣλСֱλŵλУλСҲֻҪ("SlideBitBoard()")λͿˡ
+ */
+struct BitBoardStruct {
+  uint64_t qwLow, qwHigh;
+  void InitZero(void) {
+    qwLow = qwHigh = 0;
+  }
+  void Xor(const BitBoardStruct &bb) {
+    qwLow ^= bb.qwLow;
+    qwHigh ^= bb.qwHigh;
+  }
+  void Xor(const BitBoardStruct &bb1, const BitBoardStruct &bb2) {
+    qwLow ^= bb1.qwLow ^ bb2.qwLow;
+    qwHigh ^= bb1.qwHigh ^ bb2.qwHigh;
+  }
+  bool IsZero(void) const {
+    return (qwLow | qwHigh) == 0;
+  }
+  bool IsMulti(void) const { // Ƿһλ
+    return (qwLow & (qwLow - 1)) != 0 || (qwHigh & (qwHigh - 1)) != 0 || (qwLow != 0 && qwHigh != 0);
+  }
+  int LowSquare(void) const { // λӦĸӣλ̲Ϊ
+    int nBit;
+    if (qwLow != 0) {
+      nBit = (LOW_LONG(qwLow) != 0 ? Bsf(LOW_LONG(qwLow)) : Bsf(HIGH_LONG(qwLow)) + 32);
+    } else {
+      nBit = (LOW_LONG(qwHigh) != 0 ? Bsf(LOW_LONG(qwHigh)) : Bsf(HIGH_LONG(qwHigh)) + 32) + 45;
+    }
+    return (nBit / 9 + RANK_TOP) * 16 + nBit % 9 + FILE_LEFT;
+  }
+}; // bb
+
+inline BitBoardStruct operator &(const BitBoardStruct &bb1, const BitBoardStruct &bb2) {
+  BitBoardStruct bb;
+  bb.qwLow = bb1.qwLow & bb2.qwLow;
+  bb.qwHigh = bb1.qwHigh & bb2.qwHigh;
+  return bb;
+}
+
+inline BitBoardStruct operator |(const BitBoardStruct &bb1, const BitBoardStruct &bb2) {
+  BitBoardStruct bb;
+  bb.qwLow = bb1.qwLow | bb2.qwLow;
+  bb.qwHigh = bb1.qwHigh | bb2.qwHigh;
+  return bb;
+}
+
+// б߷ĸ"bbKnightAttackTab""bbBishopAttackTab"˳
+static const int cnDiagonalTab[4] = {-0x11, -0x0f, +0x0f, +0x11};
+
 // λС͡λСɳŷԤýṹ
 struct SlideMoveStruct {
   uint8_t ucNonCap[2];    // ߵһ/Сһ
@@ -224,8 +277,36 @@ extern struct PreGenStruct {
   uint8_t ucsqKnightMoves[256][12];
   uint8_t ucsqKnightPins[256][8];
   uint8_t ucsqPawnMoves[2][256][4];
+
+  /* λ̵Ԥ
+   *
+   * ⲿ¼ǡܳԵĳӵŷԤķ෴ڽжϺͱжϣ
+   * ()鰴Ȼ(Ŀбڸ񣬲"cnDiagonalTab")ֻֿȻûʱá
+   */
+  BitBoardStruct bbSquareMask[256];          // ÿӵλλ
+  uint64_t qwFileBitsTab[32];                // λ(5λ)Ӧĵ0еĸӣ"SlideBitBoard()"
+  BitBoardStruct bbKingAttackTab[256];       // ܳԵøӵ˧()λ
+  BitBoardStruct bbAdvisorAttackTab[256];    // ܳԵøӵ(ʿ)λ
+  BitBoardStruct bbBishopAttackTab[256][4];  // ͨĳܳԵøӵ()λ
+  BitBoardStruct bbKnightAttackTab[256][4];  // ͨĳܳԵøӵλ
+  BitBoardStruct bbPawnAttackTab[2][256];    // ܳԵøӵĳһ()λ
 } PreGen;
 
+// ɸкеĳλ("SlideMaskStruct"ĳԱ)õλ
+inline BitBoardStruct SlideBitBoard(int x, int y, int wRankMask, int wFileMask) {
+  BitBoardStruct bb;
+  x -= FILE_LEFT;
+  y -= RANK_TOP;
+  bb.qwLow = PreGen.qwFileBitsTab[wFileMask & 31] << x;
+  bb.qwHigh = PreGen.qwFileBitsTab[wFileMask >> 5] << x;
+  if (y < 5) {
+    bb.qwLow |= (uint64_t) wRankMask << (y * 9);
+  } else {
+    bb.qwHigh |= (uint64_t) wRankMask << ((y - 5) * 9);
+  }
+  return bb;
+}
+
 // Ԥ۽ṹ
 extern struct PreEvalStruct {
   bool bPromotion;
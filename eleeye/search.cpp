@@ -23,9 +23,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef CCHESS_A3800
 #include <stdio.h>
 #endif
+#include <string.h>
 #include "../base/base2.h"
 #include "pregen.h"
 #include "position.h"
+#include "preeval.h"
 #include "hash.h"
 #ifndef CCHESS_A3800
 #include "ucci.h"
@@ -35,9 +37,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "search.h"
 
 const int IID_DEPTH = 2;         // ڲ
-const int SMP_DEPTH = 6;         // 
 const int UNCHANGED_DEPTH = 4;   // δıŷ
 
+const int FUTILITY_DEPTH = 2;    // Чü굶ü
+const int LMR_DEPTH = 2;         // ŷ˥С
+const int LMR_DEPTH2 = 5;        // ŷ˥С
+
+const int ASPIRATION_DEPTH = 4;      // ʹÿڵС
+const int ASPIRATION_WINDOW = 20;    // ڵĳʼȣÿʱӱ
+const int ASPIRATION_MAX = 400;      // ڵİȳֵ͸
+
 const int DROPDOWN_VALUE = 20;   // ķֵ
 const int RESIGN_VALUE = 300;    // ķֵ
 const int DRAW_OFFER_VALUE = 40; // ͵ķֵ
@@ -47,22 +56,119 @@ SearchStruct Search;
 // ϢǷװģڲ
 static struct {
     int64_t llTime;                     // ʱ
-    bool bStop, bPonderStop;            // ֹźźͺ̨˼Ϊֹź
+    volatile bool bStop;                // ֹź(߳ҲҪȡ)
+    volatile bool bPonderStop;          // ̨˼Ϊֹź(߳ҲҪȡ)
+    volatile bool bPonderHit, bDrawHit; // ߳յ"ponderhit""ponderhit draw"ָ
+    volatile bool bQuitHit;             // ߳յ"quit"ָ
+    volatile bool bReaderBusy;          // ߳Ƿ
     bool bPopPv, bPopCurrMove;          // Ƿpvcurrmove
     int nPopDepth, vlPopValue;          // Ⱥͷֵ
-    int nAllNodes, nMainNodes;          // ܽĽ
     int nUnchanged;                     // δıŷ
+    int nThreads;                       // õ߳
     uint16_t wmvPvLine[MAX_MOVE_NUM];   // Ҫ·ϵŷб
-    uint16_t wmvKiller[LIMIT_DEPTH][2]; // ɱŷ
-    MoveSortStruct MoveSort;            // ŷ
 } Search2;
 
+/* ͳƣÿ̸߳һݣܣڵµ
+ * 1. û;̬û̽кͲü
+ * 2. ŲüĳԴͳɹ
+ * 3. ضϵĽԼһŷͽضϵĽӳŷ
+ * 4. ̬Ľӳ̬ܽеıأ
+ * 5. ۻ̽дԼ͵ڸηصĴ
+ * 6. Чü굶üĴ
+ * û۵ļֲ߳̾("hash.cpp""evaluate.cpp")߳̽ʱת浽
+ */
+struct SearchStatStruct {
+    int nHashProbes, nHashHits, nHashCuts;   // û̽дͲü
+    int nHashQProbes, nHashQHits;            // ̬û̽(Բü)
+    int nNullTries, nNullCuts;               // ŲüĳԴͳɹ
+    int nBetaCuts, nFirstCuts;               // ضϵĽ͵һŷͽضϵĽ
+    int nQuiescNodes;                        // ̬Ľ
+    int nEvalProbes, nEvalHits;              // ۻ̽д
+    int nEvalStages[EVAL_STAGE_NUM];         // ͵ڸηصĴ
+    int nFutilityPrunes, nRazorPrunes;       // Чüŷ굶üĽ
+
+    void Add(const SearchStatStruct &stat) { // ۼһ̵߳ͳ
+        int i;
+        nHashProbes += stat.nHashProbes;
+        nHashHits += stat.nHashHits;
+        nHashCuts += stat.nHashCuts;
+        nHashQProbes += stat.nHashQProbes;
+        nHashQHits += stat.nHashQHits;
+        nNullTries += stat.nNullTries;
+        nNullCuts += stat.nNullCuts;
+        nBetaCuts += stat.nBetaCuts;
+        nFirstCuts += stat.nFirstCuts;
+        nQuiescNodes += stat.nQuiescNodes;
+        nEvalProbes += stat.nEvalProbes;
+        nEvalHits += stat.nEvalHits;
+        for (i = 0; i < EVAL_STAGE_NUM; i ++) {
+            nEvalStages[i] += stat.nEvalStages[i];
+        }
+        nFutilityPrunes += stat.nFutilityPrunes;
+        nRazorPrunes += stat.nRazorPrunes;
+    }
+};
+
+// 㱾̵ֲ߳߳̾ÿ߳̿ʼʱ
+inline void ClearLocalStat(void) {
+    nHashProbes = nHashHits = 0;
+    nEvalCacheProbes = nEvalCacheHits = 0;
+    memset(nEvalStageExits, 0, sizeof(nEvalStageExits));
+}
+
+// ѱ̵ֲ߳߳̾ת浽ͳУÿ߳̽ʱ
+inline void SaveLocalStat(SearchStatStruct &stat) {
+    int i;
+    stat.nHashProbes = nHashProbes;
+    stat.nHashHits = nHashHits;
+    stat.nEvalProbes = nEvalCacheProbes;
+    stat.nEvalHits = nEvalCacheHits;
+    for (i = 0; i < EVAL_STAGE_NUM; i ++) {
+        stat.nEvalStages[i] = nEvalStageExits[i];
+    }
+}
+
+/* ̵߳Ϣÿ̸߳һݣ0߳̾߳
+ *
+ * ElephantEyeĶ߳"Lazy SMP"ķʽ
+ * 1. ̹߳ûϢ(桢ɱŷʷ)Զ
+ * 2. ̸ֻ߳жϵáϢ;ŷ
+ * 3. ̸̷ֱֹ߳߳źš
+ */
+struct SearchThreadStruct {
+    int nThreadId;                      // ̱߳
+    volatile bool bBusy;                // ߳Ƿ
+    PositionStruct pos;                 // ߳Լľ
+    int nAllNodes, nMainNodes;          // ܽĽ
+    SearchStatStruct Stat;              // ͳ
+    uint16_t wmvKiller[LIMIT_DEPTH][2]; // ɱŷ
+    MoveSortStruct MoveSortRoot;        // ŷ
+
+    int SearchQuiesc(int vlAlpha, int vlBeta);
+    int SearchCut(int vlBeta, int nDepth, bool bNoNull = false);
+    int SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine);
+    int SearchRoot(int vlAlpha, int vlBeta, int nDepth);
+    bool SearchUnique(int vlBeta, int nDepth);
+};
+
+static SearchThreadStruct SearchThreads[MAX_THREADS];
+
+// ̵߳Ľ֮
+static int AllNodes(void) {
+    int i, nNodes;
+    nNodes = 0;
+    for (i = 0; i < Search2.nThreads; i ++) {
+        nNodes += SearchThreads[i].nAllNodes;
+    }
+    return nNodes;
+}
+
 #ifndef CCHESS_A3800
 
-void BuildPos(PositionStruct &pos, const UcciCommStruct &UcciComm) {
+// ӵnMoveFromŷʼִUCCIָеĺŷ޷ʶŷֹֹͣͣλ
+static int MakeCoordMoves(PositionStruct &pos, const UcciCommStruct &UcciComm, int nMoveFrom) {
     int i, mv;
-    pos.FromFen(UcciComm.szFenStr);
-    for (i = 0; i < UcciComm.nMoveNum; i ++) {
+    for (i = nMoveFrom; i < UcciComm.nMoveNum; i ++) {
         mv = COORD_MOVE(UcciComm.lpdwMovesCoord[i]);
         if (mv == 0) {
             break;
@@ -72,17 +178,72 @@ void BuildPos(PositionStruct &pos, const UcciCommStruct &UcciComm) {
             pos.SetIrrev();
         }
     }
+    return i;
+}
+
+void BuildPos(PositionStruct &pos, const UcciCommStruct &UcciComm) {
+    pos.FromFen(UcciComm.szFenStr);
+    MakeCoordMoves(pos, UcciComm, 0);
+}
+
+/* һ"UpdatePos()"õFENŷбŷΪ-1ʾûм¼
+ * ŷб޷ʶŷʱҲ¼Ϊ"BuildPos()"ֹͣ
+ */
+const int MAX_FEN_CHAR = 256;
+
+static struct {
+    int nMoveNum;
+    char szFenStr[MAX_FEN_CHAR];
+    uint32_t dwMovesCoord[MAX_MOVE_NUM];
+} LastPos = {-1, "", {0}};
+
+/* UCCI湹ֻ̣浱ǰľ棬"BuildPos()"ͬ
+ * ÿһᷢ"position ... moves ..."ָͨһָһŷ
+ * ʱͻعбڣֻҪִӵŷͿˣԾвÿζFENʼִмٸŷ
+ */
+void UpdatePos(PositionStruct &pos, const UcciCommStruct &UcciComm) {
+    int nMoveFrom, nMoveEnd;
+    // 1. FENͬһεŷбһεĿͷ֣ôһνĵطFENʼ
+    if (LastPos.nMoveNum >= 0 && UcciComm.nMoveNum >= LastPos.nMoveNum && strcmp(UcciComm.szFenStr, LastPos.szFenStr) == 0 &&
+            memcmp(UcciComm.lpdwMovesCoord, LastPos.dwMovesCoord, LastPos.nMoveNum * sizeof(uint32_t)) == 0) {
+        nMoveFrom = LastPos.nMoveNum;
+    } else {
+        pos.FromFen(UcciComm.szFenStr);
+        nMoveFrom = 0;
+    }
+    nMoveEnd = MakeCoordMoves(pos, UcciComm, nMoveFrom);
+
+    // 2. ¼һεFENŷб
+    if (nMoveEnd < UcciComm.nMoveNum || strlen(UcciComm.szFenStr) >= MAX_FEN_CHAR) {
+        LastPos.nMoveNum = -1;
+    } else {
+        strcpy(LastPos.szFenStr, UcciComm.szFenStr);
+        memcpy(LastPos.dwMovesCoord + nMoveFrom, UcciComm.lpdwMovesCoord + nMoveFrom, (nMoveEnd - nMoveFrom) * sizeof(uint32_t));
+        LastPos.nMoveNum = nMoveEnd;
+    }
 }
 
 #endif
 
-// ж
+/* жֻ̣߳ÿɽһΣֻд־ͼʱκ
+ * 1. "stop""quit"ֱ߳ӷֹźţ
+ * 2. "ponderhit"߳ñ־̨˼ģʽ̨˼ΪֹźѾôֹ
+ *    ߳յ"ponderhit"ʱ˺̨˼ΪֹźţҲֱӷֹźš
+ */
 static bool Interrupt(void) {
     if (Search.bIdle) {
         Idle();
     }
+    if (Search2.bPonderHit && Search.bPonder) {
+        Search.bPonder = false;
+        Search.bDraw = Search.bDraw || Search2.bDrawHit;
+        if (Search2.bPonderStop) {
+            Search2.bStop = true;
+            return true;
+        }
+    }
     if (Search.nGoMode == GO_MODE_NODES) {
-        if (!Search.bPonder && Search2.nAllNodes > Search.nNodes * 4) {
+        if (!Search.bPonder && AllNodes() > Search.nNodes * 4) {
             Search2.bStop = true;
             return true;
         }
@@ -92,66 +253,80 @@ static bool Interrupt(void) {
             return true;
         }
     }
-    if (Search.bBatch) {
-        return false;
-    }
+    return Search2.bStop;
+}
 
-#ifdef CCHESS_A3800
-    return false;
-#else
+#ifndef CCHESS_A3800
+
+const int READER_TIMEOUT = 1; // ߳ÿεȴʱ()ֹ߳ྭôʱ˳
+
+/* ̣߳ʱ(ģʽ)߳ȡͽUCCIָֹ˳
+ * ʱأ"stop"Ӧʱ"idle"ѡԼ"Interrupt()"ĵƵʶ޹ء
+ * ̺߳߳ͬʱϢÿϢһ"printf()"һС
+ */
+static void *SearchReader(void *) {
     UcciCommStruct UcciComm;
     PositionStruct posProbe;
-    // ģʽôȵUCCIͳжǷֹ
-    switch (BusyLine(UcciComm, Search.bDebug)) {
+    // 󲻻ָؼȴ
+    while (!Search2.bStop && !InputEof()) {
+        switch (BusyLine(UcciComm, Search.bDebug, READER_TIMEOUT)) {
         case UCCI_COMM_ISREADY:
             // "isready"ָʵû
             printf("readyok\n");
             fflush(stdout);
-            return false;
-        case UCCI_COMM_PONDERHIT:
-            // "ponderhit"ָʱܣ"SearchMain()"ΪѾ㹻ʱ䣬 ôֹź
-            if (Search2.bPonderStop) {
-                Search2.bStop = true;
-                return true;
-            } else {
-                Search.bPonder = false;
-                return false;
-            }
+            break;
         case UCCI_COMM_PONDERHIT_DRAW:
             // "ponderhit draw"ָʱܣͱ־
-            Search.bDraw = true;
+            Search2.bDrawHit = true;
+            // û"break;"ִ"ponderhit"ָ
+            // fall through
+        case UCCI_COMM_PONDERHIT:
+            // "ponderhit"ָʱܣ"SearchMain()"ΪѾ㹻ʱ䣬ôֹź
+            Search2.bPonderHit = true;
             if (Search2.bPonderStop) {
                 Search2.bStop = true;
-                return true;
-            } else {
-                Search.bPonder = false;
-                return false;
             }
+            break;
         case UCCI_COMM_STOP:
             // "stop"ָֹź
             Search2.bStop = true;
-            return true;
+            break;
         case UCCI_COMM_PROBE:
-            // "probe"ָHashϢ
+            // "probe"ָHashϢûǿͬʱд
             BuildPos(posProbe, UcciComm);
             PopHash(posProbe);
-            return false;
+            break;
         case UCCI_COMM_QUIT:
             // "quit"ָ˳ź
-            Search.bQuit = Search2.bStop = true;
-            return true;
+            Search2.bQuitHit = true;
+            Search2.bStop = true;
+            break;
         default:
-            return false;
+            break;
+        }
     }
-#endif
+    Search2.bReaderBusy = false;
+    return NULL;
 }
 
+#endif
+
 #ifndef CCHESS_A3800
 
+// ͳ߳ڵı߽磬ͳʱԼ֪ƶ
+static void PopBound(int nDepth, int vl, const char *szBound) {
+    if (Search2.bPopPv || Search.bDebug) {
+        printf("info depth %d score %d %s\n", nDepth, vl, szBound);
+        fflush(stdout);
+    }
+}
+
 // Ҫ
 static void PopPvLine(int nDepth = 0, int vl = 0) {
     uint16_t *lpwmv;
     uint32_t dwMoveStr;
+    char *lp;
+    char szLineStr[MAX_MOVE_NUM * 5 + 64];
     // δﵽҪȣô¼ȺͷֵԺ
     if (nDepth > 0 && !Search2.bPopPv && !Search.bDebug) {
         Search2.nPopDepth = nDepth;
@@ -159,7 +334,7 @@ static void PopPvLine(int nDepth = 0, int vl = 0) {
         return;
     }
     // ʱ
-    printf("info time %d nodes %d\n", (int) (GetTime() - Search2.llTime), Search2.nAllNodes);
+    printf("info time %d nodes %d\n", (int) (GetTime() - Search2.llTime), AllNodes());
     fflush(stdout);
     if (nDepth == 0) {
         // Ѿô
@@ -173,21 +348,22 @@ static void PopPvLine(int nDepth = 0, int vl = 0) {
         // ﵽҪȣôԺ󲻱
         Search2.nPopDepth = Search2.vlPopValue = 0;
     }
-    printf("info depth %d score %d pv", nDepth, vl);
+    // ߳ҲͬʱϢƴúһ
+    lp = szLineStr + sprintf(szLineStr, "info depth %d score %d pv", nDepth, vl);
     lpwmv = Search2.wmvPvLine;
     while (*lpwmv != 0) {
         dwMoveStr = MOVE_COORD(*lpwmv);
-        printf(" %.4s", (const char *) &dwMoveStr);
+        lp += sprintf(lp, " %.4s", (const char *) &dwMoveStr);
         lpwmv ++;
     }
-    printf("\n");
+    printf("%s\n", szLineStr);
     fflush(stdout);
 }
 
 #endif
 
 // ޺ü
-static int HarmlessPruning(const PositionStruct &pos, int vlBeta) {
+static int HarmlessPruning(PositionStruct &pos, int vlBeta) {
     int vl, vlRep;
 
     // 1. ɱ岽ü
@@ -218,12 +394,13 @@ inline int Evaluate(const PositionStruct &pos, int vlAlpha, int vlBeta) {
 }
 
 // ̬
-static int SearchQuiesc(PositionStruct &pos, int vlAlpha, int vlBeta) {
+int SearchThreadStruct::SearchQuiesc(int vlAlpha, int vlBeta) {
     int vlBest, vl, mv;
     bool bInCheck;
     MoveSortStruct MoveSort;
     // ̬̰¼裺
-    Search2.nAllNodes ++;
+    nAllNodes ++;
+    Stat.nQuiescNodes ++;
 
     // 1. ޺ü
     vl = HarmlessPruning(pos, vlBeta);
@@ -231,19 +408,23 @@ static int SearchQuiesc(PositionStruct &pos, int vlAlpha, int vlBeta) {
         return vl;
     }
 
-#ifdef HASH_QUIESC
-    // 3. ûü
-  vl = ProbeHashQ(pos, vlAlpha, vlBeta);
-  if (Search.bUseHash && vl > -MATE_VALUE) {
-    return vl;
-  }
-#endif
+    // 3. ûü(ֻз˾̬û)
+    if (lpqwHashQ != NULL) {
+        Stat.nHashQProbes ++;
+        vl = ProbeHashQ(pos, vlAlpha, vlBeta);
+        if (vl > -MATE_VALUE) {
+            Stat.nHashQHits ++;
+            if (Search.bUseHash) {
+                return vl;
+            }
+        }
+    }
 
     // 4. ﵽȣֱӷֵ
     if (pos.nDistance == LIMIT_DEPTH) {
         return Evaluate(pos, vlAlpha, vlBeta);
     }
-    __ASSERT(Search.pos.nDistance < LIMIT_DEPTH);
+    __ASSERT(pos.nDistance < LIMIT_DEPTH);
 
     // 5. ʼ
     vlBest = -MATE_VALUE;
@@ -259,9 +440,7 @@ static int SearchQuiesc(PositionStruct &pos, int vlAlpha, int vlBeta) {
         __ASSERT_BOUND(1 - WIN_VALUE, vl, WIN_VALUE - 1);
         __ASSERT(vl > vlBest);
         if (vl >= vlBeta) {
-#ifdef HASH_QUIESC
             RecordHashQ(pos, vl, MATE_VALUE);
-#endif
             return vl;
         }
         vlBest = vl;
@@ -275,15 +454,13 @@ static int SearchQuiesc(PositionStruct &pos, int vlAlpha, int vlBeta) {
     while ((mv = MoveSort.NextQuiesc(bInCheck)) != 0) {
         __ASSERT(bInCheck || pos.ucpcSquares[DST(mv)] > 0);
         if (pos.MakeMove(mv)) {
-            vl = -SearchQuiesc(pos, -vlBeta, -vlAlpha);
+            vl = -SearchQuiesc(-vlBeta, -vlAlpha);
             pos.UndoMakeMove();
             if (vl > vlBest) {
                 if (vl >= vlBeta) {
-#ifdef HASH_QUIESC
                     if (vl > -WIN_VALUE && vl < WIN_VALUE) {
-            RecordHashQ(pos, vl, MATE_VALUE);
-          }
-#endif
+                        RecordHashQ(pos, vl, MATE_VALUE);
+                    }
                     return vl;
                 }
                 vlBest = vl;
@@ -297,11 +474,9 @@ static int SearchQuiesc(PositionStruct &pos, int vlAlpha, int vlBeta) {
         __ASSERT(pos.IsMate());
         return pos.nDistance - MATE_VALUE;
     } else {
-#ifdef HASH_QUIESC
         if (vlBest > -WIN_VALUE && vlBest < WIN_VALUE) {
-      RecordHashQ(pos, vlBest > vlAlpha ? vlBest : -MATE_VALUE, vlBest);
-    }
-#endif
+            RecordHashQ(pos, vlBest > vlAlpha ? vlBest : -MATE_VALUE, vlBest);
+        }
         return vlBest;
     }
 }
@@ -311,8 +486,9 @@ static int SearchQuiesc(PositionStruct &pos, int vlAlpha, int vlBeta) {
 // UCCI֧ - ҶӽľϢ
 void PopLeaf(PositionStruct &pos) {
     int vl;
-    Search2.nAllNodes = 0;
-    vl = SearchQuiesc(pos, -MATE_VALUE, MATE_VALUE);
+    SearchThreads[0].pos = pos;
+    SearchThreads[0].nAllNodes = 0;
+    vl = SearchThreads[0].SearchQuiesc(-MATE_VALUE, MATE_VALUE);
     printf("pophash lowerbound %d depth 0 upperbound %d depth 0\n", vl, vl);
     fflush(stdout);
 }
@@ -321,98 +497,173 @@ void PopLeaf(PositionStruct &pos) {
 
 const bool NO_NULL = true; // "SearchCut()"ĲǷֹŲü
 
+// ü̶¿ʼ˥ŷ(0ʾ˥)
+static const int cnLmrMoves[4] = {0, 0, 6, 3};
+
+/* Чü(Futility Pruning)굶ü(Razoring)ı߽磬ȡֵ
+ *
+ * 1. Чü̬ۼϱ߽ԲAlphaôӡŷˣ
+ * 2. 굶ü̬ۼϱ߽ԲAlphaôֻ̬̬ҲAlphaֱӷأ
+ * ߽ȡ͵۵ı߽磬"EVAL_MARGIN1"ǾƽĲֿܴﵽֵ
+ */
+static const int cnFutilityMargin[FUTILITY_DEPTH + 1] = {0, EVAL_MARGIN2, EVAL_MARGIN1};
+static const int cnRazorMargin[FUTILITY_DEPTH + 1] = {0, EVAL_MARGIN1, EVAL_MARGIN1 + EVAL_MARGIN2};
+
+/* ŷ˥(LMR)ظߵŷӦĲ£
+ *
+ * 1. ǰûбҲûнԷ
+ * 2. ŷʷ׶(ûŷõĳŷɱŷ)Ҳǳŷ
+ * 3. ŷŴﵽ"cnLmrMoves"Ҫ
+ * 4. ü̶ʱʷзֵܺͲ0ŷһ("movesort.cpp"е"SetHistory()")
+ */
+inline int LateMoveReduction(const PositionStruct &pos, const MoveSortStruct &MoveSort, int nMoves, int nNewDepth, bool bInCheck) {
+    if (cnLmrMoves[Search.nPruning] == 0 || bInCheck || nNewDepth < LMR_DEPTH || nMoves <= cnLmrMoves[Search.nPruning]) {
+        return 0;
+    }
+    if (MoveSort.nPhase != PHASE_REST || pos.LastMove().CptDrw > 0 || pos.LastMove().ChkChs > 0) {
+        return 0;
+    }
+    if (Search.nPruning == 3 && nNewDepth >= LMR_DEPTH2 && MoveSort.mvs[MoveSort.nMoveIndex - 1].wvl <= HISTORY_MAX * 3 + 1) {
+        return 2;
+    }
+    return 1;
+}
+
 // 㴰ȫ
-static int SearchCut(int vlBeta, int nDepth, bool bNoNull = false) {
-    int nNewDepth, vlBest, vl;
+int SearchThreadStruct::SearchCut(int vlBeta, int nDepth, bool bNoNull) {
+    int nNewDepth, nReduction, nMoves, nQuiets, vlBest, vl, vlFutility;
     int mvHash, mv, mvEvade;
+    bool bInCheck;
     MoveSortStruct MoveSort;
+    uint16_t wmvQuiets[MAX_GEN_MOVES];
     // ȫ̰¼裺
 
     // 1. Ҷӽ㴦þ̬
     if (nDepth <= 0) {
         __ASSERT(nDepth >= -NULL_DEPTH);
-        return SearchQuiesc(Search.pos, vlBeta - 1, vlBeta);
+        return SearchQuiesc(vlBeta - 1, vlBeta);
     }
-    Search2.nAllNodes ++;
+    nAllNodes ++;
 
     // 2. ޺ü
-    vl = HarmlessPruning(Search.pos, vlBeta);
+    vl = HarmlessPruning(pos, vlBeta);
     if (vl > -MATE_VALUE) {
         return vl;
     }
 
     // 3. ûü
-    vl = ProbeHash(Search.pos, vlBeta - 1, vlBeta, nDepth, bNoNull, mvHash);
+    vl = ProbeHash(pos, vlBeta - 1, vlBeta, nDepth, bNoNull, mvHash);
     if (Search.bUseHash && vl > -MATE_VALUE) {
+        Stat.nHashCuts ++;
         return vl;
     }
 
     // 4. ﵽȣֱӷֵ
-    if (Search.pos.nDistance == LIMIT_DEPTH) {
-        return Evaluate(Search.pos, vlBeta - 1, vlBeta);
+    if (pos.nDistance == LIMIT_DEPTH) {
+        return Evaluate(pos, vlBeta - 1, vlBeta);
     }
-    __ASSERT(Search.pos.nDistance < LIMIT_DEPTH);
+    __ASSERT(pos.nDistance < LIMIT_DEPTH);
 
     // 5. жϵã
-    Search2.nMainNodes ++;
+    nMainNodes ++;
     vlBest = -MATE_VALUE;
-    if ((Search2.nMainNodes & Search.nCountMask) == 0 && Interrupt()) {
+    if (nThreadId == 0 && (nMainNodes & Search.nCountMask) == 0 && Interrupt()) {
         return vlBest;
     }
 
-    // 6. ԿŲü
-    if (Search.bNullMove && !bNoNull && Search.pos.LastMove().ChkChs <= 0 && Search.pos.NullOkay()) {
-        Search.pos.NullMove();
+    // 6. ǳ㳢굶üΪЧü׼
+    bInCheck = (pos.LastMove().ChkChs > 0);
+    vlFutility = MATE_VALUE;
+    if (Search.nPruning >= 2 && !bInCheck && nDepth <= FUTILITY_DEPTH && vlBeta > -WIN_VALUE && vlBeta < WIN_VALUE) {
+        vl = Evaluate(pos, vlBeta - 1, vlBeta);
+        if (Search.nPruning == 3 && vl + cnRazorMargin[nDepth] < vlBeta) {
+            vl = SearchQuiesc(vlBeta - 1, vlBeta);
+            if (vl < vlBeta) {
+                Stat.nRazorPrunes ++;
+                return vl;
+            }
+        } else {
+            vlFutility = vl + cnFutilityMargin[nDepth];
+        }
+    }
+
+    // 7. ԿŲü
+    if (Search.bNullMove && !bNoNull && !bInCheck && pos.NullOkay()) {
+        Stat.nNullTries ++;
+        pos.NullMove();
         vl = -SearchCut(1 - vlBeta, nDepth - NULL_DEPTH - 1, NO_NULL);
-        Search.pos.UndoNullMove();
+        pos.UndoNullMove();
         if (Search2.bStop) {
             return vlBest;
         }
 
         if (vl >= vlBeta) {
-            if (Search.pos.NullSafe()) {
+            if (pos.NullSafe()) {
                 // a. Ųü飬ô¼Ϊ(NULL_DEPTH + 1)
-                RecordHash(Search.pos, HASH_BETA, vl, MAX(nDepth, NULL_DEPTH + 1), 0);
+                RecordHash(pos, HASH_BETA, vl, MAX(nDepth, NULL_DEPTH + 1), 0);
+                Stat.nNullCuts ++;
                 return vl;
             } else if (SearchCut(vlBeta, nDepth - NULL_DEPTH, NO_NULL) >= vlBeta) {
                 // b. Ųü飬ô¼Ϊ(NULL_DEPTH)
-                RecordHash(Search.pos, HASH_BETA, vl, MAX(nDepth, NULL_DEPTH), 0);
+                RecordHash(pos, HASH_BETA, vl, MAX(nDepth, NULL_DEPTH), 0);
+                Stat.nNullCuts ++;
                 return vl;
             }
         }
     }
 
-    // 7. ʼ
-    if (Search.pos.LastMove().ChkChs > 0) {
+    // 8. ʼ
+    if (bInCheck) {
         // ǽ棬ôӦŷ
-        mvEvade = MoveSort.InitEvade(Search.pos, mvHash, Search2.wmvKiller[Search.pos.nDistance]);
+        mvEvade = MoveSort.InitEvade(pos, mvHash, wmvKiller[pos.nDistance]);
     } else {
         // ǽ棬ôʹŷб
-        MoveSort.InitFull(Search.pos, mvHash, Search2.wmvKiller[Search.pos.nDistance]);
+        MoveSort.InitFull(pos, mvHash, wmvKiller[pos.nDistance]);
         mvEvade = 0;
     }
 
-    // 8. "MoveSortStruct::NextFull()"̵ŷ˳һ
-    while ((mv = MoveSort.NextFull(Search.pos)) != 0) {
-        if (Search.pos.MakeMove(mv)) {
+    // 9. "MoveSortStruct::NextFull()"̵ŷ˳һ
+    nMoves = nQuiets = 0;
+    while ((mv = MoveSort.NextFull(pos)) != 0) {
+        if (pos.MakeMove(mv)) {
+            nMoves ++;
+
+            // 10. Чüʷ׶εĲӡŷҪѱ߽Ϊֵ
+            if (vlFutility < vlBeta && MoveSort.nPhase == PHASE_REST && pos.LastMove().CptDrw <= 0 && pos.LastMove().ChkChs <= 0) {
+                pos.UndoMakeMove();
+                Stat.nFutilityPrunes ++;
+                vlBest = MAX(vlBest, vlFutility);
+                continue;
+            }
 
-            // 9. ѡ죻
-            nNewDepth = (Search.pos.LastMove().ChkChs > 0 || mvEvade != 0 ? nDepth : nDepth - 1);
+            // 11. ѡ죻
+            nNewDepth = (pos.LastMove().ChkChs > 0 || mvEvade != 0 ? nDepth : nDepth - 1);
 
-            // 10. 㴰
-            vl = -SearchCut(1 - vlBeta, nNewDepth);
-            Search.pos.UndoMakeMove();
+            // 12. 㴰ŷ˥߽߳ʱ
+            nReduction = LateMoveReduction(pos, MoveSort, nMoves, nNewDepth, bInCheck);
+            vl = -SearchCut(1 - vlBeta, nNewDepth - nReduction);
+            if (nReduction > 0 && vl >= vlBeta && !Search2.bStop) {
+                vl = -SearchCut(1 - vlBeta, nNewDepth);
+            }
+            pos.UndoMakeMove();
             if (Search2.bStop) {
                 return vlBest;
             }
+            // ¼ĲŷضʱҪʷп۷
+            if (!MoveSort.GoodCap(pos, mv)) {
+                wmvQuiets[nQuiets] = mv;
+                nQuiets ++;
+            }
 
-            // 11. ضж
+            // 13. ضж
             if (vl > vlBest) {
                 vlBest = vl;
                 if (vl >= vlBeta) {
-                    RecordHash(Search.pos, HASH_BETA, vlBest, nDepth, mv);
-                    if (!MoveSort.GoodCap(Search.pos, mv)) {
-                        SetBestMove(mv, nDepth, Search2.wmvKiller[Search.pos.nDistance]);
+                    Stat.nBetaCuts ++;
+                    Stat.nFirstCuts += (nMoves == 1 ? 1 : 0);
+                    RecordHash(pos, HASH_BETA, vlBest, nDepth, mv);
+                    if (!MoveSort.GoodCap(pos, mv)) {
+                        SetBestMove(pos, mv, nDepth, wmvKiller[pos.nDistance], wmvQuiets, nQuiets);
                     }
                     return vlBest;
                 }
@@ -420,12 +671,12 @@ static int SearchCut(int vlBeta, int nDepth, bool bNoNull = false) {
         }
     }
 
-    // 12. ضϴʩ
+    // 14. ضϴʩ
     if (vlBest == -MATE_VALUE) {
-        __ASSERT(Search.pos.IsMate());
-        return Search.pos.nDistance - MATE_VALUE;
+        __ASSERT(pos.IsMate());
+        return pos.nDistance - MATE_VALUE;
     } else {
-        RecordHash(Search.pos, HASH_ALPHA, vlBest, nDepth, mvEvade);
+        RecordHash(pos, HASH_ALPHA, vlBest, nDepth, mvEvade);
         return vlBest;
     }
 }
@@ -450,45 +701,47 @@ static void AppendPvLine(uint16_t *lpwmvDst, uint16_t mv, const uint16_t *lpwmvS
  * 4. PVҪȡҪ
  * 5. PV㴦ŷ
  */
-static int SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine) {
-    int nNewDepth, nHashFlag, vlBest, vl;
+int SearchThreadStruct::SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine) {
+    int nNewDepth, nHashFlag, nMoves, nQuiets, vlBest, vl;
     int mvBest, mvHash, mv, mvEvade;
     MoveSortStruct MoveSort;
     uint16_t wmvPvLine[LIMIT_DEPTH];
+    uint16_t wmvQuiets[MAX_GEN_MOVES];
     // ȫ̰¼裺
 
     // 1. Ҷӽ㴦þ̬
     *lpwmvPvLine = 0;
     if (nDepth <= 0) {
         __ASSERT(nDepth >= -NULL_DEPTH);
-        return SearchQuiesc(Search.pos, vlAlpha, vlBeta);
+        return SearchQuiesc(vlAlpha, vlBeta);
     }
-    Search2.nAllNodes ++;
+    nAllNodes ++;
 
     // 2. ޺ü
-    vl = HarmlessPruning(Search.pos, vlBeta);
+    vl = HarmlessPruning(pos, vlBeta);
     if (vl > -MATE_VALUE) {
         return vl;
     }
 
     // 3. ûü
-    vl = ProbeHash(Search.pos, vlAlpha, vlBeta, nDepth, NO_NULL, mvHash);
+    vl = ProbeHash(pos, vlAlpha, vlBeta, nDepth, NO_NULL, mvHash);
     if (Search.bUseHash && vl > -MATE_VALUE) {
+        Stat.nHashCuts ++;
         // PV㲻ûüԲᷢPV·жϵ
         return vl;
     }
 
     // 4. ﵽȣֱӷֵ
-    __ASSERT(Search.pos.nDistance > 0);
-    if (Search.pos.nDistance == LIMIT_DEPTH) {
-        return Evaluate(Search.pos, vlAlpha, vlBeta);
+    __ASSERT(pos.nDistance > 0);
+    if (pos.nDistance == LIMIT_DEPTH) {
+        return Evaluate(pos, vlAlpha, vlBeta);
     }
-    __ASSERT(Search.pos.nDistance < LIMIT_DEPTH);
+    __ASSERT(pos.nDistance < LIMIT_DEPTH);
 
     // 5. жϵã
-    Search2.nMainNodes ++;
+    nMainNodes ++;
     vlBest = -MATE_VALUE;
-    if ((Search2.nMainNodes & Search.nCountMask) == 0 && Interrupt()) {
+    if (nThreadId == 0 && (nMainNodes & Search.nCountMask) == 0 && Interrupt()) {
         return vlBest;
     }
 
@@ -508,21 +761,23 @@ static int SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine)
     // 7. ʼ
     mvBest = 0;
     nHashFlag = HASH_ALPHA;
-    if (Search.pos.LastMove().ChkChs > 0) {
+    if (pos.LastMove().ChkChs > 0) {
         // ǽ棬ôӦŷ
-        mvEvade = MoveSort.InitEvade(Search.pos, mvHash, Search2.wmvKiller[Search.pos.nDistance]);
+        mvEvade = MoveSort.InitEvade(pos, mvHash, wmvKiller[pos.nDistance]);
     } else {
         // ǽ棬ôʹŷб
-        MoveSort.InitFull(Search.pos, mvHash, Search2.wmvKiller[Search.pos.nDistance]);
+        MoveSort.InitFull(pos, mvHash, wmvKiller[pos.nDistance]);
         mvEvade = 0;
     }
 
     // 8. "MoveSortStruct::NextFull()"̵ŷ˳һ
-    while ((mv = MoveSort.NextFull(Search.pos)) != 0) {
-        if (Search.pos.MakeMove(mv)) {
+    nMoves = nQuiets = 0;
+    while ((mv = MoveSort.NextFull(pos)) != 0) {
+        if (pos.MakeMove(mv)) {
+            nMoves ++;
 
             // 9. ѡ죻
-            nNewDepth = (Search.pos.LastMove().ChkChs > 0 || mvEvade != 0 ? nDepth : nDepth - 1);
+            nNewDepth = (pos.LastMove().ChkChs > 0 || mvEvade != 0 ? nDepth : nDepth - 1);
 
             // 10. Ҫ
             if (vlBest == -MATE_VALUE) {
@@ -533,15 +788,21 @@ static int SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine)
                     vl = -SearchPV(-vlBeta, -vlAlpha, nNewDepth, wmvPvLine);
                 }
             }
-            Search.pos.UndoMakeMove();
+            pos.UndoMakeMove();
             if (Search2.bStop) {
                 return vlBest;
             }
+            if (!MoveSort.GoodCap(pos, mv)) {
+                wmvQuiets[nQuiets] = mv;
+                nQuiets ++;
+            }
 
             // 11. Alpha-Beta߽ж
             if (vl > vlBest) {
                 vlBest = vl;
                 if (vl >= vlBeta) {
+                    Stat.nBetaCuts ++;
+                    Stat.nFirstCuts += (nMoves == 1 ? 1 : 0);
                     mvBest = mv;
                     nHashFlag = HASH_BETA;
                     break;
@@ -558,12 +819,12 @@ static int SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine)
 
     // 12. ûʷɱŷ
     if (vlBest == -MATE_VALUE) {
-        __ASSERT(Search.pos.IsMate());
-        return Search.pos.nDistance - MATE_VALUE;
+        __ASSERT(pos.IsMate());
+        return pos.nDistance - MATE_VALUE;
     } else {
-        RecordHash(Search.pos, nHashFlag, vlBest, nDepth, mvEvade == 0 ? mvBest : mvEvade);
-        if (mvBest != 0 && !MoveSort.GoodCap(Search.pos, mvBest)) {
-            SetBestMove(mvBest, nDepth, Search2.wmvKiller[Search.pos.nDistance]);
+        RecordHash(pos, nHashFlag, vlBest, nDepth, mvEvade == 0 ? mvBest : mvEvade);
+        if (mvBest != 0 && !MoveSort.GoodCap(pos, mvBest)) {
+            SetBestMove(pos, mvBest, nDepth, wmvKiller[pos.nDistance], wmvQuiets, nQuiets);
         }
         return vlBest;
     }
@@ -578,71 +839,81 @@ static int SearchPV(int vlAlpha, int vlBeta, int nDepth, uint16_t *lpwmvPvLine)
  * 5. ŷʱҪܶദ(¼Ҫ)
  * 6. ʷɱŷ
  */
-static int SearchRoot(int nDepth) {
+int SearchThreadStruct::SearchRoot(int vlAlpha, int vlBeta, int nDepth) {
     int nNewDepth, vlBest, vl, mv, nCurrMove;
 #ifndef CCHESS_A3800
     uint32_t dwMoveStr;
 #endif
     uint16_t wmvPvLine[LIMIT_DEPTH];
-    // ̰¼裺
+    // ̰¼裬(vlAlpha, vlBeta)ɵĿھ
+    // ֵ"vlAlpha"ʾͳڣ"vlBeta"ʾ߳ڣҪ
 
     // 1. ʼ
     vlBest = -MATE_VALUE;
-    Search2.MoveSort.ResetRoot();
+    MoveSortRoot.ResetRoot();
 
     // 2. һÿŷ(Ҫ˽ֹŷ)
     nCurrMove = 0;
-    while ((mv = Search2.MoveSort.NextRoot()) != 0) {
-        if (Search.pos.MakeMove(mv)) {
+    while ((mv = MoveSortRoot.NextRoot()) != 0) {
+        if (pos.MakeMove(mv)) {
+            nCurrMove ++;
 #ifndef CCHESS_A3800
-            if (Search2.bPopCurrMove || Search.bDebug) {
+            if (nThreadId == 0 && (Search2.bPopCurrMove || Search.bDebug)) {
                 dwMoveStr = MOVE_COORD(mv);
-                nCurrMove ++;
                 printf("info currmove %.4s currmovenumber %d\n", (const char *) &dwMoveStr, nCurrMove);
                 fflush(stdout);
             }
 #endif
 
             // 3. ѡ(ֻǽ)
-            nNewDepth = (Search.pos.LastMove().ChkChs > 0 ? nDepth : nDepth - 1);
+            nNewDepth = (pos.LastMove().ChkChs > 0 ? nDepth : nDepth - 1);
 
-            // 4. Ҫ
-            if (vlBest == -MATE_VALUE) {
-                vl = -SearchPV(-MATE_VALUE, MATE_VALUE, nNewDepth, wmvPvLine);
-                __ASSERT(vl > vlBest);
+            // 4. Ҫһŷô(vlAlpha, vlBeta)ŷ㴰
+            if (nCurrMove == 1) {
+                vl = -SearchPV(-vlBeta, -vlAlpha, nNewDepth, wmvPvLine);
             } else {
-                vl = -SearchCut(-vlBest, nNewDepth);
-                if (vl > vlBest) { // ﲻҪ" && vl < MATE_VALUE"
-                    vl = -SearchPV(-MATE_VALUE, -vlBest, nNewDepth, wmvPvLine);
+                wmvPvLine[0] = 0; // 㴰߳ʱҪֻһŷ
+                vl = -SearchCut(-vlAlpha, nNewDepth);
+                if (vl > vlAlpha && vl < vlBeta) {
+                    vl = -SearchPV(-vlBeta, -vlAlpha, nNewDepth, wmvPvLine);
                 }
             }
-            Search.pos.UndoMakeMove();
+            pos.UndoMakeMove();
             if (Search2.bStop) {
                 return vlBest;
             }
 
-            // 5. Alpha-Beta߽ж("vlBest""SearchPV()"е"vlAlpha")
-            if (vl > vlBest) {
+            // 5. Alpha-Beta߽жֻг"vlAlpha"ŷŷ
+            vlBest = MAX(vlBest, vl);
+            if (vl > vlAlpha) {
+                vlAlpha = vl;
 
-                // 6. һŷô"δıŷ"ļ1
-                Search2.nUnchanged = (vlBest == -MATE_VALUE ? Search2.nUnchanged + 1 : 0);
-                vlBest = vl;
+                // 6. ֻ߳Ҫ¸ŷб(7)(8)̴߳
+                if (nThreadId == 0) {
 
-                // 7. ŷʱ¼Ҫ
-                AppendPvLine(Search2.wmvPvLine, mv, wmvPvLine);
+                    // 7. ŷʱ¼Ҫ߳ʱ"SearchMain()"߽
+                    AppendPvLine(Search2.wmvPvLine, mv, wmvPvLine);
 #ifndef CCHESS_A3800
-                PopPvLine(nDepth, vl);
+                    if (vl < vlBeta) {
+                        PopPvLine(nDepth, vl);
+                    }
 #endif
 
-                // 8. ҪԣAlphaֵҪɱʱ
-                if (vlBest > -WIN_VALUE && vlBest < WIN_VALUE) {
-                    vlBest += (Search.rc4Random.NextLong() & Search.nRandomMask) -
-                              (Search.rc4Random.NextLong() & Search.nRandomMask);
-                    vlBest = (vlBest == Search.pos.DrawValue() ? vlBest - 1 : vlBest);
+                    // 8. ҪԣAlphaֵҪɱʱ
+                    if (vlAlpha > -WIN_VALUE && vlAlpha < WIN_VALUE) {
+                        vlAlpha += (Search.rc4Random.NextLong() & Search.nRandomMask) -
+                                   (Search.rc4Random.NextLong() & Search.nRandomMask);
+                        vlAlpha = (vlAlpha == pos.DrawValue() ? vlAlpha - 1 : vlAlpha);
+                    }
                 }
 
                 // 9. ¸ŷб
-                Search2.MoveSort.UpdateRoot(mv);
+                MoveSortRoot.UpdateRoot(mv);
+
+                // 10. ߳ڣŷ
+                if (vl >= vlBeta) {
+                    break;
+                }
             }
         }
     }
@@ -652,14 +923,14 @@ static int SearchRoot(int nDepth) {
 // ΨһŷElephantEyeϵһɫжĳȽеǷҵΨһŷ
 // ԭǰҵŷɽֹŷȻ(-WIN_VALUE, 1 - WIN_VALUE)Ĵ
 // ͳ߽˵ŷɱ
-static bool SearchUnique(int vlBeta, int nDepth) {
+bool SearchThreadStruct::SearchUnique(int vlBeta, int nDepth) {
     int vl, mv;
-    Search2.MoveSort.ResetRoot(ROOT_UNIQUE);
+    MoveSortRoot.ResetRoot(ROOT_UNIQUE);
     // һŷ
-    while ((mv = Search2.MoveSort.NextRoot()) != 0) {
-        if (Search.pos.MakeMove(mv)) {
-            vl = -SearchCut(1 - vlBeta, Search.pos.LastMove().ChkChs > 0 ? nDepth : nDepth - 1);
-            Search.pos.UndoMakeMove();
+    while ((mv = MoveSortRoot.NextRoot()) != 0) {
+        if (pos.MakeMove(mv)) {
+            vl = -SearchCut(1 - vlBeta, pos.LastMove().ChkChs > 0 ? nDepth : nDepth - 1);
+            pos.UndoMakeMove();
             if (Search2.bStop || vl >= vlBeta) {
                 return false;
             }
@@ -668,9 +939,78 @@ static bool SearchUnique(int vlBeta, int nDepth) {
     return true;
 }
 
+// ̵߳ڣ̷ֱֹ߳ź
+static void *SearchHelper(void *lpParameter) {
+    int i;
+    SearchThreadStruct *lpThread;
+    lpThread = (SearchThreadStruct *) lpParameter;
+    // ߳ÿģֲ߳̾ʷһʼǿյģ
+    ClearLocalStat();
+    // ŵ̴߳ӵ2㿪ʼʹ߳ȴ
+    for (i = 1 + (lpThread->nThreadId & 1); i < LIMIT_DEPTH && !Search2.bStop; i ++) {
+        lpThread->SearchRoot(-MATE_VALUE, MATE_VALUE, i);
+    }
+    // û۵ļֲ߳̾ģ˳ǰ̻߳
+    SaveLocalStat(lpThread->Stat);
+    lpThread->bBusy = false;
+    return NULL;
+}
+
+#ifndef CCHESS_A3800
+
+/* ͳƣ
+ * 1. ûռ("info hashfull")
+ * 2. ģʽ·ɶͳƣ
+ * 3. "stats"ѡʱһ"info stats"ȫ" ֵ"ʽýűܡ
+ */
+static void PopStats(void) {
+    int i, nAllNodes, nMainNodes, nHashFull;
+    SearchStatStruct Stat;
+
+    memset(&Stat, 0, sizeof(SearchStatStruct));
+    nAllNodes = nMainNodes = 0;
+    for (i = 0; i < Search2.nThreads; i ++) {
+        Stat.Add(SearchThreads[i].Stat);
+        nAllNodes += SearchThreads[i].nAllNodes;
+        nMainNodes += SearchThreads[i].nMainNodes;
+    }
+    nHashFull = HashFull();
+    printf("info hashfull %d\n", nHashFull);
+    if (Search.bDebug) {
+        printf("info hash probes %d hits %d cuts %d\n", Stat.nHashProbes, Stat.nHashHits, Stat.nHashCuts);
+        if (lpqwHashQ != NULL) {
+            printf("info qhash probes %d hits %d\n", Stat.nHashQProbes, Stat.nHashQHits);
+        }
+        if (lpqwEvalCache != NULL) {
+            printf("info evalcache probes %d hits %d\n", Stat.nEvalProbes, Stat.nEvalHits);
+        }
+        printf("info evalstage %d %d %d %d %d\n", Stat.nEvalStages[0], Stat.nEvalStages[1],
+                Stat.nEvalStages[2], Stat.nEvalStages[3], Stat.nEvalStages[4]);
+        printf("info nullmove tries %d cuts %d\n", Stat.nNullTries, Stat.nNullCuts);
+        printf("info betacut nodes %d first %d\n", Stat.nBetaCuts, Stat.nFirstCuts);
+        printf("info qnodes %d of %d\n", Stat.nQuiescNodes, nAllNodes);
+        printf("info prune futility %d razor %d\n", Stat.nFutilityPrunes, Stat.nRazorPrunes);
+    }
+    if (Search.bStats) {
+        printf("info stats nodes %d mainnodes %d qnodes %d", nAllNodes, nMainNodes, Stat.nQuiescNodes);
+        printf(" hashprobes %d hashhits %d hashcuts %d", Stat.nHashProbes, Stat.nHashHits, Stat.nHashCuts);
+        printf(" qhashprobes %d qhashhits %d", Stat.nHashQProbes, Stat.nHashQHits);
+        printf(" nulltries %d nullcuts %d", Stat.nNullTries, Stat.nNullCuts);
+        printf(" betacuts %d firstcuts %d", Stat.nBetaCuts, Stat.nFirstCuts);
+        printf(" evalprobes %d evalhits %d", Stat.nEvalProbes, Stat.nEvalHits);
+        for (i = 0; i < EVAL_STAGE_NUM; i ++) {
+            printf(" evalstage%d %d", i, Stat.nEvalStages[i]);
+        }
+        printf(" futility %d razor %d hashfull %d\n", Stat.nFutilityPrunes, Stat.nRazorPrunes, nHashFull);
+    }
+    fflush(stdout);
+}
+
+#endif
+
 // 
 void SearchMain(int nDepth) {
-    int i, vl, vlLast, nDraw;
+    int i, vl, vlLast, vlAlpha, vlBeta, nDelta, nDraw, mvLast;
     int nCurrTimer, nLimitTimer, nLimitNodes;
     bool bUnique;
 #ifndef CCHESS_A3800
@@ -680,6 +1020,10 @@ void SearchMain(int nDepth) {
 #endif
     // ̰¼裺
 
+    // 0. ûں̨գȴ
+    WaitHash();
+    Search.nAllNodes = 0;
+
     // 1. ֱӷ
     if (Search.pos.IsDraw() || Search.pos.RepStatus(3) > 0) {
 #ifndef CCHESS_A3800
@@ -736,7 +1080,8 @@ void SearchMain(int nDepth) {
     // 3. Ϊ򷵻ؾֵ̬
     if (nDepth == 0) {
 #ifndef CCHESS_A3800
-        printf("info depth 0 score %d\n", SearchQuiesc(Search.pos, -MATE_VALUE, MATE_VALUE));
+        SearchThreads[0].pos = Search.pos;
+        printf("info depth 0 score %d\n", SearchThreads[0].SearchQuiesc(-MATE_VALUE, MATE_VALUE));
         fflush(stdout);
         printf("nobestmove\n");
         fflush(stdout);
@@ -745,18 +1090,52 @@ void SearchMain(int nDepth) {
     }
 
     // 4. ɸÿŷ
-    Search2.MoveSort.InitRoot(Search.pos, Search.nBanMoves, Search.wmvBanList);
+    SearchThreads[0].pos = Search.pos;
+    SearchThreads[0].MoveSortRoot.InitRoot(Search.pos, Search.nBanMoves, Search.wmvBanList);
 
     // 5. ʼʱͼ
-    Search2.bStop = Search2.bPonderStop = Search2.bPopPv = Search2.bPopCurrMove = false;
+    Search2.bStop = false;
+    Search2.bPonderStop = false;
+    Search2.bPopPv = Search2.bPopCurrMove = false;
+    Search2.bPonderHit = false;
+    Search2.bDrawHit = false;
+    Search2.bQuitHit = false;
+    Search2.bReaderBusy = false;
     Search2.nPopDepth = Search2.vlPopValue = 0;
-    Search2.nAllNodes = Search2.nMainNodes = Search2.nUnchanged = 0;
+    Search2.nUnchanged = 0;
+    Search2.nThreads = MIN(MAX(Search.nThreads, 1), MAX_THREADS);
     Search2.wmvPvLine[0] = 0;
-    ClearKiller(Search2.wmvKiller);
-    ClearHistory();
-    ClearHash();
-    //  ClearHash() Ҫһʱ䣬ԼʱԺʼȽϺ
+    for (i = 0; i < Search2.nThreads; i ++) {
+        SearchThreads[i].nThreadId = i;
+        SearchThreads[i].nAllNodes = SearchThreads[i].nMainNodes = 0;
+        memset(&SearchThreads[i].Stat, 0, sizeof(SearchStatStruct));
+        ClearKiller(SearchThreads[i].wmvKiller);
+    }
+    // ûʷһ(̨˼)Ľֻ"newgame"ʱգ
+    // ûеɱֵ¼ڸýĲ˻˸Ȼʹ
+    AgeHistory();
+    NewHashGen();
+    ClearLocalStat();
     Search2.llTime = GetTime();
+    // ̣߳ǵľ͸ŷб̸߳
+    for (i = 1; i < Search2.nThreads; i ++) {
+        SearchThreads[i].pos = Search.pos;
+        SearchThreads[i].MoveSortRoot = SearchThreads[0].MoveSortRoot;
+        SearchThreads[i].bBusy = true;
+        // ޷ĸ̲߳μ̲߳ص
+        if (!StartThread(SearchHelper, SearchThreads + i)) {
+            SearchThreads[i].bBusy = false;
+        }
+    }
+#ifndef CCHESS_A3800
+    // ģʽ̣߳ʱָ
+    if (!Search.bBatch) {
+        Search2.bReaderBusy = true;
+        if (!StartThread(SearchReader, NULL)) {
+            Search2.bReaderBusy = false;
+        }
+    }
+#endif
     vlLast = 0;
     // 10غŷôͣԺÿ8غһ
     nDraw = -Search.pos.LastMove().CptDrw;
@@ -776,12 +1155,46 @@ void SearchMain(int nDepth) {
         }
 
         // 7. ʱǷҪҪ͵ǰ˼ŷ
-        Search2.bPopPv = (nCurrTimer > 300);
-        Search2.bPopCurrMove = (nCurrTimer > 3000);
+        Search2.bPopPv = (nCurrTimer > 300 && !Search.bQuiet);
+        Search2.bPopCurrMove = (nCurrTimer > 3000 && !Search.bQuiet);
 #endif
 
-        // 8. 
-        vl = SearchRoot(i);
+        // 8. 㣬һķֵΪÿڣͳ߳ʱſ
+        mvLast = Search2.wmvPvLine[0];
+        nDelta = ASPIRATION_WINDOW;
+        if (i >= ASPIRATION_DEPTH && vlLast > -WIN_VALUE && vlLast < WIN_VALUE) {
+            vlAlpha = vlLast - nDelta;
+            vlBeta = vlLast + nDelta;
+        } else {
+            vlAlpha = -MATE_VALUE;
+            vlBeta = MATE_VALUE;
+        }
+        while (true) {
+            vl = SearchThreads[0].SearchRoot(vlAlpha, vlBeta, i);
+            if (Search2.bStop || (vl > vlAlpha && vl < vlBeta)) {
+                break;
+            }
+            nDelta *= 2;
+            if (vl <= vlAlpha) {
+                if (vlAlpha == -MATE_VALUE) {
+                    break;
+                }
+#ifndef CCHESS_A3800
+                PopBound(i, vl, "upperbound");
+#endif
+                vlAlpha = (nDelta > ASPIRATION_MAX ? -MATE_VALUE : MAX(vl - nDelta, -MATE_VALUE));
+            } else {
+                if (vlBeta == MATE_VALUE) {
+                    break;
+                }
+#ifndef CCHESS_A3800
+                PopBound(i, vl, "lowerbound");
+#endif
+                vlBeta = (nDelta > ASPIRATION_MAX ? MATE_VALUE : MIN(vl + nDelta, MATE_VALUE));
+            }
+        }
+        // ŷһͬô"δıŷ"ļ1
+        Search2.nUnchanged = (mvLast == 0 || Search2.wmvPvLine[0] == mvLast ? Search2.nUnchanged + 1 : 0);
         if (Search2.bStop) {
             if (vl > -MATE_VALUE) {
                 vlLast = vl; // vlLastжͶҪһֵ
@@ -812,7 +1225,7 @@ void SearchMain(int nDepth) {
             nLimitNodes = (vl + DROPDOWN_VALUE >= vlLast ? nLimitNodes / 2 : nLimitNodes);
             nLimitNodes = (Search2.nUnchanged >= UNCHANGED_DEPTH ? nLimitNodes / 2 : nLimitNodes);
             // GO_MODE_NODESǲӳ̨˼ʱ
-            if (Search2.nAllNodes > nLimitNodes) {
+            if (AllNodes() > nLimitNodes) {
                 vlLast = vl;
                 break;
             }
@@ -825,16 +1238,42 @@ void SearchMain(int nDepth) {
         }
 
         // 11. Ψһŷֹ
-        if (SearchUnique(1 - WIN_VALUE, i)) {
+        if (SearchThreads[0].SearchUnique(1 - WIN_VALUE, i)) {
             bUnique = true;
             break;
         }
     }
 
+    // 12. ֹ֪̺ͨ߳߳ȴ˳߳˳ŷߴ˺ָ
+    Search2.bStop = true;
+    for (i = 1; i < Search2.nThreads; i ++) {
+        while (SearchThreads[i].bBusy) {
+            Idle();
+        }
+    }
+    while (Search2.bReaderBusy) {
+        Idle();
+    }
+    // ߳յ"ponderhit"Ժֹܾˣͱ־˳źҪת
+    if (Search2.bPonderHit) {
+        Search.bPonder = false;
+        Search.bDraw = Search.bDraw || Search2.bDrawHit;
+    }
+    Search.bQuit = Search.bQuit || Search2.bQuitHit;
+    SaveLocalStat(SearchThreads[0].Stat);
+    Search.nAllNodes = AllNodes();
+
 #ifdef CCHESS_A3800
     Search.mvResult = Search2.wmvPvLine[0];
 #else
-    // 12. ŷӦ(Ϊ̨˼Ĳ²ŷ)
+    // ׼ʱ"go"ָĻӦ
+    if (Search.bQuiet) {
+        return;
+    }
+    // ͳ
+    PopStats();
+
+    // 13. ŷӦ(Ϊ̨˼Ĳ²ŷ)
     if (Search2.wmvPvLine[0] != 0) {
         PopPvLine();
         dwMoveStr = MOVE_COORD(Search2.wmvPvLine[0]);
@@ -844,7 +1283,7 @@ void SearchMain(int nDepth) {
             printf(" ponder %.4s", (const char *) &dwMoveStr);
         }
 
-        // 13. жǷͣǾΨһŷĲʺ(ΪȲ)
+        // 14. жǷͣǾΨһŷĲʺ(ΪȲ)
         if (!bUnique) {
             if (vlLast > -WIN_VALUE && vlLast < -RESIGN_VALUE) {
                 printf(" resign");
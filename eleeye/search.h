@@ -36,11 +36,14 @@ const int GO_MODE_INFINITY = 0;
 const int GO_MODE_NODES = 1;
 const int GO_MODE_TIMER = 2;
 
+const int MAX_THREADS = 32; // ߳
+
 // ǰõȫֱָ
 struct SearchStruct {
     PositionStruct pos;                // дľ
     bool bQuit, bPonder, bDraw;        // Ƿյ˳ָ̨˼ģʽģʽ
-    bool bBatch, bDebug;               // Ƿģʽ͵ģʽ
+    bool bBatch, bDebug, bStats;       // Ƿģʽģʽͳ
+    bool bQuiet;                       // ǷҪͳƺŷ(׼)
     bool bUseHash, bUseBook;           // ǷʹûüͿֿ
     bool bNullMove, bKnowledge;        // ǷŲüʹþ֪ʶ
     bool bIdle;                        // Ƿ
@@ -48,6 +51,9 @@ struct SearchStruct {
     int nGoMode, nNodes, nCountMask;   // ģʽ
     int nProperTimer, nMaxTimer;       // ƻʹʱ
     int nRandomMask, nBanMoves;        // λͽ
+    int nThreads;                      // ߳
+    int nPruning;                      // ü̶(0=ü1=Ųü23=ŲüͲ̶ͬȵĺŷ˥)
+    int nAllNodes;                     // ɺ󷵻صĽ(׼)
     uint16_t wmvBanList[MAX_MOVE_NUM]; // б
     char szBookFile[1024];             // ֿ
 #ifdef CCHESS_A3800
@@ -62,6 +68,9 @@ extern SearchStruct Search;
 // UCCI湹
 void BuildPos(PositionStruct &pos, const UcciCommStruct &UcciComm);
 
+// UCCI湹()ֻ浱ǰľ棬µָһεʱִֻӵŷ
+void UpdatePos(PositionStruct &pos, const UcciCommStruct &UcciComm);
+
 // UCCI֧ - ҶӽľϢ
 void PopLeaf(PositionStruct &pos);
 
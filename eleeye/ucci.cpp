@@ -20,7 +20,7 @@ can be used without restriction.
  * еһ"BootLine()"򵥣ֻĵһָ
  * "ucci"ʱͷ"UCCI_COMM_UCCI"һɷ"UCCI_COMM_UNKNOWN"
  * ǰȴǷ룬ûִдָ"Idle()"
- * ("BusyLine()"ֻ˼ʱ)ûʱֱӷ"UCCI_COMM_UNKNOWN"
+ * ("BusyLine()"ֻ˼ʱģ̵߳)ûʱȴһʱ󷵻"UCCI_COMM_UNKNOWN"
  */
 static PipeStruct pipeStd;
 
@@ -175,7 +175,7 @@ UcciCommEnum IdleLine(UcciCommStruct &UcciComm, bool bDebug) {
     // (10) "hashsize"ѡ
     } else if (StrEqvSkip(lp, "hashsize ")) {
       UcciComm.Option = UCCI_OPTION_HASHSIZE;
-      UcciComm.nSpin = Str2Digit(lp, 0, 1024);
+      UcciComm.nSpin = Str2Digit(lp, 0, UCCI_MAX_HASHSIZE);
 
     // (11) "threads"ѡ
     } else if (StrEqvSkip(lp, "threads ")) {
@@ -279,7 +279,28 @@ UcciCommEnum IdleLine(UcciCommStruct &UcciComm, bool bDebug) {
     } else if (StrEqv(lp, "newgame")) {
       UcciComm.Option = UCCI_OPTION_NEWGAME;
 
-    // (19) ޷ʶѡ
+    // (19) "qhashsize"ѡ̬ûĴС0ʾʹ
+    } else if (StrEqvSkip(lp, "qhashsize ")) {
+      UcciComm.Option = UCCI_OPTION_QHASHSIZE;
+      UcciComm.nSpin = Str2Digit(lp, 0, UCCI_MAX_HASHSIZE);
+
+    // (20) "evalcache"ѡۻĴС(KBΪλ)0ʾʹ
+    } else if (StrEqvSkip(lp, "evalcache ")) {
+      UcciComm.Option = UCCI_OPTION_EVALCACHE;
+      UcciComm.nSpin = Str2Digit(lp, 0, UCCI_MAX_EVALCACHE);
+
+    // (21) "stats"ѡÿǷһͳ("info stats")
+    } else if (StrEqvSkip(lp, "stats ")) {
+      UcciComm.Option = UCCI_OPTION_STATS;
+      if (StrEqv(lp, "on")) {
+        UcciComm.bCheck = true;
+      } else if (StrEqv(lp, "true")) {
+        UcciComm.bCheck = true;
+      } else {
+        UcciComm.bCheck = false;
+      }
+
+    // (22) ޷ʶѡ
     } else {
       UcciComm.Option = UCCI_OPTION_UNKNOWN;
     }
@@ -354,16 +375,50 @@ UcciCommEnum IdleLine(UcciCommStruct &UcciComm, bool bDebug) {
   } else if (StrEqv(lp, "quit")) {
     return UCCI_COMM_QUIT;
 
-  // 9. ޷ʶָ
+  // 9. "savehash <file>"ָ
+  } else if (StrEqvSkip(lp, "savehash ")) {
+    UcciComm.szFileName = lp;
+    return UCCI_COMM_SAVEHASH;
+
+  // 10. "loadhash <file>"ָ
+  } else if (StrEqvSkip(lp, "loadhash ")) {
+    UcciComm.szFileName = lp;
+    return UCCI_COMM_LOADHASH;
+
+  // 11. "bench [<depth>]"ָע⣺ж"bench "ж"bench"
+  } else if (StrEqvSkip(lp, "bench ")) {
+    UcciComm.nBenchDepth = Str2Digit(lp, 1, UCCI_MAX_DEPTH);
+    return UCCI_COMM_BENCH;
+  } else if (StrEqv(lp, "bench")) {
+    UcciComm.nBenchDepth = 0;
+    return UCCI_COMM_BENCH;
+
+  // 12. "perft <depth> [hash]""divide <depth> [hash]"ָ
+  } else if (StrEqvSkip(lp, "perft ")) {
+    UcciComm.nPerftDepth = Str2Digit(lp, 1, UCCI_MAX_DEPTH);
+    UcciComm.bDivide = false;
+    UcciComm.bPerftHash = StrScan(lp, " hash");
+    return UCCI_COMM_PERFT;
+  } else if (StrEqvSkip(lp, "divide ")) {
+    UcciComm.nPerftDepth = Str2Digit(lp, 1, UCCI_MAX_DEPTH);
+    UcciComm.bDivide = true;
+    UcciComm.bPerftHash = StrScan(lp, " hash");
+    return UCCI_COMM_PERFT;
+
+  // 13. ޷ʶָ
   } else {
     return UCCI_COMM_UNKNOWN;
   }
 }
 
-UcciCommEnum BusyLine(UcciCommStruct &UcciComm, bool bDebug) {
+bool InputEof(void) {
+  return pipeStd.nEof != 0;
+}
+
+UcciCommEnum BusyLine(UcciCommStruct &UcciComm, bool bDebug, int nTimeout) {
   char szLineStr[LINE_INPUT_MAX_CHAR];
   char *lp;
-  if (pipeStd.LineInput(szLineStr)) {
+  if (pipeStd.LineInput(szLineStr, nTimeout)) {
     if (bDebug) {
       printf("info busyline [%s]\n", szLineStr);
       fflush(stdout);
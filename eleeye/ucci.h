@@ -15,12 +15,15 @@ can be used without restriction.
 #define UCCI_H
 
 const int UCCI_MAX_DEPTH = 32; // UCCI˼ļ
+const int UCCI_MAX_HASHSIZE = 1048576; // UCCIûֵ(MBΪλ1TB)
+const int UCCI_MAX_EVALCACHE = 4194304; // UCCIۻֵ(KBΪλ4GB)
 
 // UCCIָйؼйصѡ
 enum UcciOptionEnum {
   UCCI_OPTION_UNKNOWN, UCCI_OPTION_BATCH, UCCI_OPTION_DEBUG, UCCI_OPTION_PONDER, UCCI_OPTION_USEHASH, UCCI_OPTION_USEBOOK, UCCI_OPTION_USEEGTB,
   UCCI_OPTION_BOOKFILES, UCCI_OPTION_EGTBPATHS, UCCI_OPTION_HASHSIZE, UCCI_OPTION_THREADS, UCCI_OPTION_PROMOTION,
-  UCCI_OPTION_IDLE, UCCI_OPTION_PRUNING, UCCI_OPTION_KNOWLEDGE, UCCI_OPTION_RANDOMNESS, UCCI_OPTION_STYLE, UCCI_OPTION_NEWGAME
+  UCCI_OPTION_IDLE, UCCI_OPTION_PRUNING, UCCI_OPTION_KNOWLEDGE, UCCI_OPTION_RANDOMNESS, UCCI_OPTION_STYLE, UCCI_OPTION_NEWGAME,
+  UCCI_OPTION_QHASHSIZE, UCCI_OPTION_EVALCACHE, UCCI_OPTION_STATS
 }; // "setoption"ָѡ
 enum UcciRepetEnum {
   UCCI_REPET_ALWAYSDRAW, UCCI_REPET_CHECKBAN, UCCI_REPET_ASIANRULE, UCCI_REPET_CHINESERULE
@@ -36,13 +39,14 @@ enum UcciGoEnum {
 }; // "go"ָָʱģʽֱ޶ȡ޶ʱƺͼʱ
 enum UcciCommEnum {
   UCCI_COMM_UNKNOWN, UCCI_COMM_UCCI, UCCI_COMM_ISREADY, UCCI_COMM_PONDERHIT, UCCI_COMM_PONDERHIT_DRAW, UCCI_COMM_STOP,
-  UCCI_COMM_SETOPTION, UCCI_COMM_POSITION, UCCI_COMM_BANMOVES, UCCI_COMM_GO, UCCI_COMM_PROBE, UCCI_COMM_QUIT
+  UCCI_COMM_SETOPTION, UCCI_COMM_POSITION, UCCI_COMM_BANMOVES, UCCI_COMM_GO, UCCI_COMM_PROBE, UCCI_COMM_QUIT,
+  UCCI_COMM_SAVEHASH, UCCI_COMM_LOADHASH, UCCI_COMM_BENCH, UCCI_COMM_PERFT
 }; // UCCIָ
 
 // UCCIָԽͳĽṹ
 union UcciCommStruct {
 
-  /* ɵõϢUCCIָֻ4
+  /* ɵõϢUCCIָֻ7
    *
    * 1. "setoption"ָݵϢʺ"UCCI_COMM_SETOPTION"ָ
    *    "setoption"ָ趨ѡܵϢСѡ͡͡ѡֵ
@@ -92,11 +96,34 @@ union UcciCommStruct {
       int nMovesToGo, nIncrement;
     }; // ޶ʱҪ߶ٲ(ʱ)ò޶ʱӶ(ʱ)
   };
+
+  /* 5. "savehash""loadhash"ָݵϢʺ"UCCI_COMM_SAVEHASH""UCCI_COMM_LOADHASH"ָ
+   *    ָû浽ļļûܵϢֻļ
+   */
+  struct {
+    const char *szFileName; // ûļ
+  };
+
+  /* 6. "bench"ָݵϢʺ"UCCI_COMM_BENCH"ָ
+   *    "bench"ָõһ׼ԣָȣ0ʾĬ
+   */
+  struct {
+    int nBenchDepth; // ׼Ե
+  };
+
+  /* 7. "perft""divide"ָݵϢʺ"UCCI_COMM_PERFT"ָ
+   *    ָԵǰֲ"divide"ҪÿŷĽ"hash"ʾʹû
+   */
+  struct {
+    int nPerftDepth;         // ֲ
+    bool bDivide, bPerftHash; // ǷÿŷĽǷʹû
+  };
 };
 
 // UCCIָڲͬ
 UcciCommEnum BootLine(void);                                  // UCCIĵһָֻ"ucci"
 UcciCommEnum IdleLine(UcciCommStruct &UcciComm, bool bDebug); // ʱָ
-UcciCommEnum BusyLine(UcciCommStruct &UcciComm, bool bDebug); // ˼ʱָֻ"stop""ponderhit""probe"
+UcciCommEnum BusyLine(UcciCommStruct &UcciComm, bool bDebug, int nTimeout = 0); // ˼ʱָֻ"stop""ponderhit""probe"ȴnTimeout
+bool InputEof(void);                                           // Ѿ(ܵر)Ժ󲻻ָ
 
 #endif